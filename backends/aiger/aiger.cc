@@ -23,22 +23,35 @@
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
-void aiger_encode(std::ostream &f, int x)
+void aiger_encode(std::string &buf, int x)
 {
 	log_assert(x >= 0);
 
 	while (x & ~0x7f) {
-		f.put((x & 0x7f) | 0x80);
+		buf.push_back((x & 0x7f) | 0x80);
 		x = x >> 7;
 	}
 
-	f.put(x);
+	buf.push_back(x);
+}
+
+// Output is collected in a string and handed to the stream in large chunks,
+// so that huge AIGs are written with bounded memory and few stream calls.
+const size_t aiger_flush_size = 1 << 20;
+
+void aiger_flush(std::ostream &f, std::string &buf, bool force = false)
+{
+	if (force || buf.size() >= aiger_flush_size) {
+		f.write(buf.data(), buf.size());
+		buf.clear();
+	}
 }
 
 struct AigerWriter
 {
 	Module *module;
 	bool zinit_mode;
+	bool strash_mode;
 	SigMap sigmap;
 
 	dict<SigBit, bool> init_map;
@@ -54,30 +67,66 @@ struct AigerWriter
 	int aig_m = 0, aig_i = 0, aig_l = 0, aig_o = 0, aig_a = 0;
 	int aig_b = 0, aig_c = 0, aig_j = 0, aig_f = 0;
 
-	dict<SigBit, int> aig_map;
+	// literals are stored in a flat array indexed by a dense bit numbering
+	idict<SigBit> aig_bits;
+	vector<int> aig_lits;
+	dict<pair<int, int>, int> strash_gates;
+
 	dict<SigBit, int> ordered_outputs;
 	dict<SigBit, int> ordered_latches;
 
 	dict<SigBit, int> init_inputs;
 	int initstate_ff = 0;
 
+	int &lit(SigBit bit)
+	{
+		int idx = aig_bits(bit);
+		if (idx >= GetSize(aig_lits))
+			aig_lits.resize(idx+1, -1);
+		return aig_lits[idx];
+	}
+
+	int lit_at(SigBit bit) const
+	{
+		int idx = aig_bits.at(bit, -1);
+		if (idx < 0 || idx >= GetSize(aig_lits) || aig_lits[idx] < 0)
+			return -1;
+		return aig_lits[idx];
+	}
+
 	int mkgate(int a0, int a1)
 	{
+		pair<int, int> key = a0 > a1 ? make_pair(a0, a1) : make_pair(a1, a0);
+
+		if (strash_mode)
+		{
+			if (key.second == 0 || key.first == (key.second ^ 1))
+				return 0;
+			if (key.second == 1 || key.first == key.second)
+				return key.first;
+
+			auto it = strash_gates.find(key);
+			if (it != strash_gates.end())
+				return it->second;
+		}
+
 		aig_m++, aig_a++;
-		aig_gates.push_back(a0 > a1 ? make_pair(a0, a1) : make_pair(a1, a0));
+		aig_gates.push_back(key);
+
+		if (strash_mode)
+			strash_gates[key] = 2*aig_m;
+
 		return 2*aig_m;
 	}
 
 	int bit2aig(SigBit bit)
 	{
-		auto it = aig_map.find(bit);
-		if (it != aig_map.end()) {
-			log_assert(it->second >= 0);
-			return it->second;
-		}
+		int cached = lit_at(bit);
+		if (cached >= 0)
+			return cached;
 
-		// NB: Cannot use iterator returned from aig_map.insert()
-		//     since this function is called recursively
+		// NB: Cannot keep a reference into aig_lits across the recursive
+		//     calls below, since they may grow the array
 
 		int a = -1;
 		if (not_map.count(bit)) {
@@ -100,11 +149,12 @@ struct AigerWriter
 			log_error("Design contains 'x' or 'z' bits. Use 'setundef' to replace those constants.\n");
 
 		log_assert(a >= 0);
-		aig_map[bit] = a;
+		lit(bit) = a;
 		return a;
 	}
 
-	AigerWriter(Module *module, bool zinit_mode, bool imode, bool omode, bool bmode, bool lmode) : module(module), zinit_mode(zinit_mode), sigmap(module)
+	AigerWriter(Module *module, bool zinit_mode, bool strash_mode, bool imode, bool omode, bool bmode, bool lmode) :
+			module(module), zinit_mode(zinit_mode), strash_mode(strash_mode), sigmap(module)
 	{
 		pool<SigBit> undriven_bits;
 		pool<SigBit> unused_bits;
@@ -141,7 +191,7 @@ struct AigerWriter
 
 				if (bit.wire == nullptr) {
 					if (wire->port_output) {
-						aig_map[wirebit] = (bit == State::S1) ? 1 : 0;
+						lit(wirebit) = (bit == State::S1) ? 1 : 0;
 						output_bits.insert(wirebit);
 					}
 					continue;
@@ -289,12 +339,12 @@ struct AigerWriter
 		ff_map.sort();
 		and_map.sort();
 
-		aig_map[State::S0] = 0;
-		aig_map[State::S1] = 1;
+		lit(State::S0) = 0;
+		lit(State::S1) = 1;
 
 		for (auto bit : input_bits) {
 			aig_m++, aig_i++;
-			aig_map[bit] = 2*aig_m;
+			lit(bit) = 2*aig_m;
 		}
 
 		if (imode && input_bits.empty()) {
@@ -319,7 +369,7 @@ struct AigerWriter
 
 		for (auto it : ff_map) {
 			aig_m++, aig_l++;
-			aig_map[it.first] = 2*aig_m;
+			lit(it.first) = 2*aig_m;
 			ordered_latches[it.first] = aig_l-1;
 			if (init_map.count(it.first) == 0)
 				aig_latchinit.push_back(2);
@@ -350,13 +400,14 @@ struct AigerWriter
 				int l = ordered_latches[it.first];
 
 				if (aig_latchinit.at(l) == 1)
-					aig_map[it.first] ^= 1;
+					lit(it.first) ^= 1;
 
 				if (aig_latchinit.at(l) == 2)
 				{
-					int gated_ffout = mkgate(aig_map[it.first], initstate_ff^1);
+					int gated_ffout = mkgate(lit(it.first), initstate_ff^1);
 					int gated_initin = mkgate(init_inputs[it.first], initstate_ff);
-					aig_map[it.first] = mkgate(gated_ffout^1, gated_initin^1)^1;
+					int a = mkgate(gated_ffout^1, gated_initin^1)^1;
+					lit(it.first) = a;
 				}
 			}
 		}
@@ -472,69 +523,72 @@ struct AigerWriter
 			f << stringf("\n");
 		}
 
+		std::string buf;
+		buf.reserve(aiger_flush_size + 64);
+
 		if (ascii_mode)
 		{
-			for (int i = 0; i < aig_i; i++)
-				f << stringf("%d\n", 2*i+2);
-
-			for (int i = 0; i < aig_l; i++) {
-				if (zinit_mode || aig_latchinit.at(i) == 0)
-					f << stringf("%d %d\n", 2*(aig_i+i)+2, aig_latchin.at(i));
-				else if (aig_latchinit.at(i) == 1)
-					f << stringf("%d %d 1\n", 2*(aig_i+i)+2, aig_latchin.at(i));
-				else if (aig_latchinit.at(i) == 2)
-					f << stringf("%d %d %d\n", 2*(aig_i+i)+2, aig_latchin.at(i), 2*(aig_i+i)+2);
+			for (int i = 0; i < aig_i; i++) {
+				append_decimal(buf, 2*i+2);
+				buf.push_back('\n');
+				aiger_flush(f, buf);
 			}
+		}
 
-			for (int i = 0; i < aig_obc; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
-
-			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("1\n");
+		for (int i = 0; i < aig_l; i++) {
+			if (ascii_mode) {
+				append_decimal(buf, 2*(aig_i+i)+2);
+				buf.push_back(' ');
+			}
+			append_decimal(buf, aig_latchin.at(i));
+			if (!zinit_mode && aig_latchinit.at(i) == 1) {
+				buf += " 1";
+			} else if (!zinit_mode && aig_latchinit.at(i) == 2) {
+				buf.push_back(' ');
+				append_decimal(buf, 2*(aig_i+i)+2);
+			}
+			buf.push_back('\n');
+			aiger_flush(f, buf);
+		}
 
-			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
+		for (int i = 0; i < aig_obc; i++) {
+			append_decimal(buf, aig_outputs.at(i));
+			buf.push_back('\n');
+			aiger_flush(f, buf);
+		}
 
-			for (int i = aig_obcj; i < aig_obcjf; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
+		for (int i = aig_obc; i < aig_obcj; i++)
+			buf += "1\n";
 
-			for (int i = 0; i < aig_a; i++)
-				f << stringf("%d %d %d\n", 2*(aig_i+aig_l+i)+2, aig_gates.at(i).first, aig_gates.at(i).second);
+		for (int i = aig_obc; i < aig_obcjf; i++) {
+			append_decimal(buf, aig_outputs.at(i));
+			buf.push_back('\n');
+			aiger_flush(f, buf);
 		}
-		else
+
+		for (int i = 0; i < aig_a; i++)
 		{
-			for (int i = 0; i < aig_l; i++) {
-				if (zinit_mode || aig_latchinit.at(i) == 0)
-					f << stringf("%d\n", aig_latchin.at(i));
-				else if (aig_latchinit.at(i) == 1)
-					f << stringf("%d 1\n", aig_latchin.at(i));
-				else if (aig_latchinit.at(i) == 2)
-					f << stringf("%d %d\n", aig_latchin.at(i), 2*(aig_i+i)+2);
+			int lhs = 2*(aig_i+aig_l+i)+2;
+			int rhs0 = aig_gates[i].first;
+			int rhs1 = aig_gates[i].second;
+
+			if (ascii_mode) {
+				append_decimal(buf, lhs);
+				buf.push_back(' ');
+				append_decimal(buf, rhs0);
+				buf.push_back(' ');
+				append_decimal(buf, rhs1);
+				buf.push_back('\n');
+			} else {
+				aiger_encode(buf, lhs - rhs0);
+				aiger_encode(buf, rhs0 - rhs1);
 			}
 
-			for (int i = 0; i < aig_obc; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
-
-			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("1\n");
-
-			for (int i = aig_obc; i < aig_obcj; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
-
-			for (int i = aig_obcj; i < aig_obcjf; i++)
-				f << stringf("%d\n", aig_outputs.at(i));
-
-			for (int i = 0; i < aig_a; i++) {
-				int lhs = 2*(aig_i+aig_l+i)+2;
-				int rhs0 = aig_gates.at(i).first;
-				int rhs1 = aig_gates.at(i).second;
-				int delta0 = lhs - rhs0;
-				int delta1 = rhs0 - rhs1;
-				aiger_encode(f, delta0);
-				aiger_encode(f, delta1);
-			}
+			aiger_flush(f, buf);
 		}
 
+		aiger_flush(f, buf, true);
+
 		if (symbols_mode)
 		{
 			dict<string, vector<string>> symbols;
@@ -556,8 +610,8 @@ struct AigerWriter
 					}
 
 					if (wire->port_input) {
-						int a = aig_map.at(sig[i]);
-						log_assert((a & 1) == 0);
+						int a = lit_at(sig[i]);
+						log_assert(a >= 0 && (a & 1) == 0);
 						if (GetSize(wire) != 1)
 							symbols[stringf("i%d", (a >> 1)-1)].push_back(stringf("%s[%d]", log_id(wire), i));
 						else
@@ -623,10 +677,12 @@ struct AigerWriter
 
 			for (int i = 0; i < GetSize(wire); i++)
 			{
-				if (aig_map.count(sig[i]) == 0 || sig[i].wire == nullptr)
+				if (sig[i].wire == nullptr)
 					continue;
 
-				int a = aig_map.at(sig[i]);
+				int a = lit_at(sig[i]);
+				if (a < 0)
+					continue;
 
 				if (verbose_map)
 					wire_lines[a] += stringf("wire %d %d %s\n", a, wire->start_offset+i, log_id(wire));
@@ -704,6 +760,11 @@ struct AigerBackend : public Backend {
 		log("    -miter\n");
 		log("        design outputs are AIGER bad state properties\n");
 		log("\n");
+		log("    -strash\n");
+		log("        merge structurally identical AND gates and propagate constants\n");
+		log("        while writing the AIG. Literals assigned to gates may differ from\n");
+		log("        the ones written without this option.\n");
+		log("\n");
 		log("    -symbols\n");
 		log("        include a symbol table in the generated AIGER file\n");
 		log("\n");
@@ -724,6 +785,7 @@ struct AigerBackend : public Backend {
 		bool ascii_mode = false;
 		bool zinit_mode = false;
 		bool miter_mode = false;
+		bool strash_mode = false;
 		bool symbols_mode = false;
 		bool verbose_map = false;
 		bool imode = false;
@@ -749,6 +811,10 @@ struct AigerBackend : public Backend {
 				miter_mode = true;
 				continue;
 			}
+			if (args[argidx] == "-strash") {
+				strash_mode = true;
+				continue;
+			}
 			if (args[argidx] == "-symbols") {
 				symbols_mode = true;
 				continue;
@@ -795,7 +861,7 @@ struct AigerBackend : public Backend {
 		if (!top_module->memories.empty())
 			log_error("Found unmapped memories in module %s: unmapped memories are not supported in AIGER backend!\n", log_id(top_module));
 
-		AigerWriter writer(top_module, zinit_mode, imode, omode, bmode, lmode);
+		AigerWriter writer(top_module, zinit_mode, strash_mode, imode, omode, bmode, lmode);
 		writer.write_aiger(*f, ascii_mode, miter_mode, symbols_mode);
 
 		if (!map_filename.empty()) {
@@ -84,10 +84,42 @@ struct BlifDumper
 							break;
 					}
 			}
+
+		if (config->noalias_mode) {
+			int num_bits = 0;
+			for (Wire *wire : module->wires()) {
+				wire_bits_offset[wire] = num_bits;
+				num_bits += wire->width;
+			}
+			wire_bits_seen.resize(num_bits);
+		}
 	}
 
+	// strings returned by cstr() only need to live until the statement using
+	// them has been written, cstr_buf is cleared after each cell and connection
 	vector<shared_str> cstr_buf;
-	pool<SigBit> cstr_bits_seen;
+
+	// bits referenced so far, only tracked for -noalias
+	dict<RTLIL::Wire*, int> wire_bits_offset;
+	std::vector<bool> wire_bits_seen;
+	pool<SigBit> const_bits_seen;
+
+	void mark_bit_seen(RTLIL::SigBit sig)
+	{
+		if (!config->noalias_mode)
+			return;
+		if (sig.wire == NULL)
+			const_bits_seen.insert(sig);
+		else
+			wire_bits_seen[wire_bits_offset.at(sig.wire) + sig.offset] = true;
+	}
+
+	bool bit_seen(RTLIL::SigBit sig) const
+	{
+		if (sig.wire == NULL)
+			return const_bits_seen.count(sig) != 0;
+		return wire_bits_seen[wire_bits_offset.at(sig.wire) + sig.offset];
+	}
 
 	const char *cstr(RTLIL::IdString id)
 	{
@@ -101,7 +133,7 @@ struct BlifDumper
 
 	const char *cstr(RTLIL::SigBit sig)
 	{
-		cstr_bits_seen.insert(sig);
+		mark_bit_seen(sig);
 
 		if (sig.wire == NULL) {
 			if (sig == RTLIL::State::S0) return config->false_type == "-" || config->false_type == "+" ? config->false_out.c_str() : "$false";
@@ -230,6 +262,8 @@ struct BlifDumper
 
 		for (auto cell : module->cells())
 		{
+			cstr_buf.clear();
+
 			if (config->unbuf_types.count(cell->type)) {
 				auto portnames = config->unbuf_types.at(cell->type);
 				f << stringf(".names %s %s\n1 1\n",
@@ -458,7 +492,9 @@ struct BlifDumper
 			SigBit lhs_bit = conn.first[i];
 			SigBit rhs_bit = conn.second[i];
 
-			if (config->noalias_mode && cstr_bits_seen.count(lhs_bit) == 0)
+			cstr_buf.clear();
+
+			if (config->noalias_mode && !bit_seen(lhs_bit))
 				continue;
 
 			if (config->conn_mode)
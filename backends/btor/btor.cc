@@ -41,6 +41,7 @@ struct BtorWorker
 	bool single_bad;
 	bool cover_mode;
 	bool print_internal_names;
+	bool coi_mode;
 
 	int next_nid = 1;
 	int initstate_nid = -1;
@@ -66,6 +67,15 @@ struct BtorWorker
 	// nids for constants
 	dict<Const, int> consts;
 
+	// (<nid>, <upper>, <lower>) => <nid>
+	dict<std::tuple<int, int, int>, int> slice_nids;
+
+	// (<nid-upper>, <nid-lower>) => <nid>
+	dict<pair<int, int>, int> concat_nids;
+
+	// (<nid>, <width>, <signed>) => <nid>
+	dict<std::tuple<int, int, int>, int> extend_nids;
+
 	// ff inputs that need to be evaluated (<nid>, <ff_cell>)
 	vector<pair<int, Cell*>> ff_todo;
 
@@ -79,12 +89,41 @@ struct BtorWorker
 	vector<string> info_lines;
 	dict<int, int> info_clocks;
 
+	// output is formatted into this buffer and written out in large blocks
+	string buffer;
+
+	void flush()
+	{
+		f.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+
+	// Only plain %d, %s, %c and %% are supported, which is all this backend
+	// needs. This avoids creating a temporary string for each line. The
+	// printf attribute only checks argument types: any other conversion, and
+	// any flag, width, precision or length modifier (e.g. "%5d", "%ld", "%x"),
+	// compiles but ends in log_abort() when the line is formatted.
 	void btorf(const char *fmt, ...) YS_ATTRIBUTE(format(printf, 2, 3))
 	{
 		va_list ap;
 		va_start(ap, fmt);
-		f << indent << vstringf(fmt, ap);
+		buffer += indent;
+		for (const char *p = fmt; *p; p++) {
+			if (*p != '%') {
+				buffer.push_back(*p);
+				continue;
+			}
+			switch (*++p) {
+				case 'd': append_decimal(buffer, va_arg(ap, int)); break;
+				case 's': buffer += va_arg(ap, const char*); break;
+				case 'c': buffer.push_back(va_arg(ap, int)); break;
+				case '%': buffer.push_back('%'); break;
+				default: log_abort();
+			}
+		}
 		va_end(ap);
+		if (buffer.size() >= (1 << 20))
+			flush();
 	}
 
 	void infof(const char *fmt, ...) YS_ATTRIBUTE(format(printf, 2, 3))
@@ -125,7 +164,7 @@ struct BtorWorker
 	void btorf_push(const string &id)
 	{
 		if (verbose) {
-			f << indent << stringf("  ; begin %s\n", id.c_str());
+			btorf("  ; begin %s\n", id.c_str());
 			indent += "    ";
 		}
 	}
@@ -134,7 +173,7 @@ struct BtorWorker
 	{
 		if (verbose) {
 			indent = indent.substr(4);
-			f << indent << stringf("  ; end %s\n", id.c_str());
+			btorf("  ; end %s\n", id.c_str());
 		}
 	}
 
@@ -164,7 +203,7 @@ struct BtorWorker
 	void add_nid_sig(int nid, const SigSpec &sig)
 	{
 		if (verbose)
-			f << indent << stringf("; %d %s\n", nid, log_signal(sig));
+			btorf("; %d %s\n", nid, log_signal(sig));
 
 		for (int i = 0; i < GetSize(sig); i++)
 			bit_nid[sig[i]] = make_pair(nid, i);
@@ -1005,17 +1044,27 @@ struct BtorWorker
 				int nid3 = nid2;
 
 				if (lower != 0 || upper+1 != nid_width.at(nid2)) {
-					int sid = get_bv_sid(upper-lower+1);
-					nid3 = next_nid++;
-					btorf("%d slice %d %d %d %d\n", nid3, sid, nid2, upper, lower);
+					auto key = std::make_tuple(nid2, upper, lower);
+					if (slice_nids.count(key) == 0) {
+						int sid = get_bv_sid(upper-lower+1);
+						int nid5 = next_nid++;
+						btorf("%d slice %d %d %d %d\n", nid5, sid, nid2, upper, lower);
+						slice_nids[key] = nid5;
+					}
+					nid3 = slice_nids.at(key);
 				}
 
 				int nid4 = nid3;
 
 				if (nid >= 0) {
-					int sid = get_bv_sid(width+upper-lower+1);
-					nid4 = next_nid++;
-					btorf("%d concat %d %d %d\n", nid4, sid, nid3, nid);
+					auto key = make_pair(nid3, nid);
+					if (concat_nids.count(key) == 0) {
+						int sid = get_bv_sid(width+upper-lower+1);
+						int nid5 = next_nid++;
+						btorf("%d concat %d %d %d\n", nid5, sid, nid3, nid);
+						concat_nids[key] = nid5;
+					}
+					nid4 = concat_nids.at(key);
 				}
 
 				width += upper-lower+1;
@@ -1033,26 +1082,35 @@ struct BtorWorker
 		{
 			if (to_width < GetSize(sig))
 			{
-				int sid = get_bv_sid(to_width);
-				int nid2 = next_nid++;
-				btorf("%d slice %d %d %d 0\n", nid2, sid, nid, to_width-1);
-				nid = nid2;
+				auto key = std::make_tuple(nid, to_width-1, 0);
+				if (slice_nids.count(key) == 0) {
+					int sid = get_bv_sid(to_width);
+					int nid2 = next_nid++;
+					btorf("%d slice %d %d %d 0\n", nid2, sid, nid, to_width-1);
+					slice_nids[key] = nid2;
+				}
+				nid = slice_nids.at(key);
 			}
 			else
 			{
-				int sid = get_bv_sid(to_width);
-				int nid2 = next_nid++;
-				btorf("%d %s %d %d %d\n", nid2, is_signed ? "sext" : "uext",
-						sid, nid, to_width - GetSize(sig));
-				nid = nid2;
+				auto key = std::make_tuple(nid, to_width, is_signed ? 1 : 0);
+				if (extend_nids.count(key) == 0) {
+					int sid = get_bv_sid(to_width);
+					int nid2 = next_nid++;
+					btorf("%d %s %d %d %d\n", nid2, is_signed ? "sext" : "uext",
+							sid, nid, to_width - GetSize(sig));
+					extend_nids[key] = nid2;
+				}
+				nid = extend_nids.at(key);
 			}
 		}
 
 		return nid;
 	}
 
-	BtorWorker(std::ostream &f, RTLIL::Module *module, bool verbose, bool single_bad, bool cover_mode, bool print_internal_names, string info_filename) :
-			f(f), sigmap(module), module(module), verbose(verbose), single_bad(single_bad), cover_mode(cover_mode), print_internal_names(print_internal_names), info_filename(info_filename)
+	BtorWorker(std::ostream &f, RTLIL::Module *module, bool verbose, bool single_bad, bool cover_mode, bool print_internal_names, bool coi_mode, string info_filename) :
+			f(f), sigmap(module), module(module), verbose(verbose), single_bad(single_bad), cover_mode(cover_mode), print_internal_names(print_internal_names),
+			coi_mode(coi_mode), info_filename(info_filename)
 	{
 		if (!info_filename.empty())
 			infof("name %s\n", log_id(module));
@@ -1093,7 +1151,7 @@ struct BtorWorker
 
 		for (auto wire : module->wires())
 		{
-			if (!wire->port_id || !wire->port_output)
+			if (coi_mode || !wire->port_id || !wire->port_output)
 				continue;
 
 			btorf_push(stringf("output %s", log_id(wire)));
@@ -1175,7 +1233,7 @@ struct BtorWorker
 
 		for (auto wire : module->wires())
 		{
-			if (wire->port_id || wire->name[0] == '$')
+			if (coi_mode || wire->port_id || wire->name[0] == '$')
 				continue;
 
 			btorf_push(stringf("wire %s", log_id(wire)));
@@ -1302,6 +1360,8 @@ struct BtorWorker
 			}
 		}
 
+		flush();
+
 		if (!info_filename.empty())
 		{
 			for (auto &it : info_clocks)
@@ -1358,10 +1418,14 @@ struct BtorBackend : public Backend {
 		log("  -x\n");
 		log("    Output symbols for internal netnames (starting with '$')\n");
 		log("\n");
+		log("  -coi\n");
+		log("    Only output the cone of influence of the assert, assume and cover\n");
+		log("    properties. Output ports and named wires are not exported.\n");
+		log("\n");
 	}
 	void execute(std::ostream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
-		bool verbose = false, single_bad = false, cover_mode = false, print_internal_names = false;
+		bool verbose = false, single_bad = false, cover_mode = false, print_internal_names = false, coi_mode = false;
 		string info_filename;
 
 		log_header(design, "Executing BTOR backend.\n");
@@ -1389,6 +1453,10 @@ struct BtorBackend : public Backend {
 				print_internal_names = true;
 				continue;
 			}
+			if (args[argidx] == "-coi") {
+				coi_mode = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
@@ -1401,7 +1469,7 @@ struct BtorBackend : public Backend {
 		*f << stringf("; BTOR description generated by %s for module %s.\n",
 				yosys_version_str, log_id(topmod));
 
-		BtorWorker(*f, topmod, verbose, single_bad, cover_mode, print_internal_names, info_filename);
+		BtorWorker(*f, topmod, verbose, single_bad, cover_mode, print_internal_names, coi_mode, info_filename);
 
 		*f << stringf("; end of yosys output\n");
 	}
@@ -32,6 +32,7 @@
 #include <limits>
 #include <type_traits>
 #include <tuple>
+#include <array>
 #include <vector>
 #include <map>
 #include <algorithm>
@@ -406,12 +407,15 @@ struct value : public expr_base<value<Bits>> {
 		size_t count = 0;
 		for (size_t n = 0; n < chunks; n++) {
 			chunk::type x = data[chunks - 1 - n];
-			if (x == 0) {
-				count += (n == 0 ? Bits % chunk::bits : chunk::bits);
-			} else {
+			// First add to `count` as if the chunk is zero.
+			constexpr size_t msb_chunk_bits = Bits % chunk::bits != 0 ? Bits % chunk::bits : chunk::bits;
+			count += (n == 0 ? msb_chunk_bits : chunk::bits);
+			// If the chunk isn't zero, correct the `count` value and stop.
+			if (x != 0) {
 				// This loop implements the find first set idiom as recognized by LLVM.
-				for (; x != 0; count++)
+				for (; x != 0; count--)
 					x >>= 1;
+				break;
 			}
 		}
 		return count;
@@ -458,17 +462,22 @@ struct value : public expr_base<value<Bits>> {
 
 	template<size_t ResultBits>
 	value<ResultBits> mul(const value<Bits> &other) const {
+		// Schoolbook multiplication, one row per chunk of this value. The partial product, the chunk of the result
+		// it is added to, and the carry from the previous column always fit into a wide chunk together.
 		value<ResultBits> result;
-		wide_chunk_t wide_result[result.chunks + 1] = {};
-		for (size_t n = 0; n < chunks; n++) {
+		for (size_t n = 0; n < chunks && n < result.chunks; n++) {
+			// Operands of multiplications are often extended to the width of the result, so their upper chunks are
+			// zero, and so are the corresponding rows.
+			if (data[n] == 0)
+				continue;
+			wide_chunk_t carry = 0;
 			for (size_t m = 0; m < chunks && n + m < result.chunks; m++) {
-				wide_result[n + m] += wide_chunk_t(data[n]) * wide_chunk_t(other.data[m]);
-				wide_result[n + m + 1] += wide_result[n + m] >> chunk::bits;
-				wide_result[n + m] &= chunk::mask;
+				carry += wide_chunk_t(data[n]) * wide_chunk_t(other.data[m]) + result.data[n + m];
+				result.data[n + m] = carry;
+				carry >>= chunk::bits;
 			}
-		}
-		for (size_t n = 0; n < result.chunks; n++) {
-			result.data[n] = wide_result[n];
+			if (n + chunks < result.chunks)
+				result.data[n + chunks] = carry;
 		}
 		result.data[result.chunks - 1] &= result.msb_mask;
 		return result;
@@ -636,7 +645,9 @@ std::ostream &operator<<(std::ostream &os, const wire<Bits> &val) {
 	return os;
 }
 
-template<size_t Width>
+// If the number of write ports of a memory is known, it may be specified as `WritePorts`. In this case, each write port
+// has a fixed slot in the write queue (see below), which avoids the need to keep the queue sorted.
+template<size_t Width, size_t WritePorts = 0>
 struct memory {
 	std::vector<value<Width>> data;
 
@@ -647,8 +658,8 @@ struct memory {
 	memory() = delete;
 	explicit memory(size_t depth) : data(depth) {}
 
-	memory(const memory<Width> &) = delete;
-	memory<Width> &operator=(const memory<Width> &) = delete;
+	memory(const memory &) = delete;
+	memory &operator=(const memory &) = delete;
 
 	// The only way to get the compiler to put the initializer in .rodata and do not copy it on stack is to stuff it
 	// into a plain array. You'd think an std::initializer_list would work here, but it doesn't, because you can't
@@ -694,6 +705,10 @@ struct memory {
 	// the writes during the commit phase in the priority order. This approach has low overhead, with both space
 	// and time proportional to the amount of write ports. Because virtually every memory in a practical design
 	// has at most two write ports, linear search is used on every write, being the fastest and simplest approach.
+	//
+	// If the number of write ports is known, the priority order is resolved when the code is generated instead:
+	// every write port is assigned a slot, with the slots ordered by priority, and the queue is a fixed array of
+	// these slots. For a memory with a single write port, this reduces the queue to one pending write.
 	struct write {
 		size_t index;
 		value<Width> val;
@@ -701,6 +716,8 @@ struct memory {
 		int priority;
 	};
 	std::vector<write> write_queue;
+	std::array<write, WritePorts> write_slots;
+	std::array<bool, WritePorts> write_slots_pending = {};
 
 	void update(size_t index, const value<Width> &val, const value<Width> &mask, int priority = 0) {
 		assert(index < data.size());
@@ -711,17 +728,47 @@ struct memory {
 			write { index, val, mask, priority });
 	}
 
+	template<size_t Slot>
+	void update(size_t index, const value<Width> &val, const value<Width> &mask) {
+		static_assert(Slot < WritePorts, "write slot out of range");
+		assert(index < data.size());
+		write_slots[Slot] = write { index, val, mask, /*priority=*/0 };
+		write_slots_pending[Slot] = true;
+	}
+
+	bool apply(const write &entry) {
+		value<Width> elem = data[entry.index];
+		elem = elem.update(entry.val, entry.mask);
+		bool changed = (data[entry.index] != elem);
+		data[entry.index] = elem;
+		if (!dirty_rows.empty())
+			dirty_rows[entry.index / 64] |= uint64_t(1) << (entry.index % 64);
+		return changed;
+	}
+
 	bool commit() {
 		bool changed = false;
-		for (const write &entry : write_queue) {
-			value<Width> elem = data[entry.index];
-			elem = elem.update(entry.val, entry.mask);
-			changed |= (data[entry.index] != elem);
-			data[entry.index] = elem;
+		for (size_t slot = 0; slot < WritePorts; slot++) {
+			if (write_slots_pending[slot]) {
+				changed |= apply(write_slots[slot]);
+				write_slots_pending[slot] = false;
+			}
+		}
+		if (!write_queue.empty()) {
+			for (const write &entry : write_queue)
+				changed |= apply(entry);
+			write_queue.clear();
 		}
-		write_queue.clear();
 		return changed;
 	}
+
+	// Incremental snapshots only copy the rows that were written since the memory was last saved to or restored from
+	// the same snapshot, provided that the snapshot was not saved from another design since then; the snapshot and
+	// its generation (incremented on every save) identify the contents the memory was last synchronized with. The rows
+	// are only tracked after the first incremental snapshot of the memory is taken.
+	size_t snapshot_id = 0;
+	size_t snapshot_generation = 0;
+	std::vector<uint64_t> dirty_rows;
 };
 
 struct metadata {
@@ -831,8 +878,8 @@ struct debug_item : ::cxxrtl_object {
 		next    = item.next.data;
 	}
 
-	template<size_t Width>
-	debug_item(memory<Width> &item, size_t zero_offset = 0) {
+	template<size_t Width, size_t WritePorts>
+	debug_item(memory<Width, WritePorts> &item, size_t zero_offset = 0) {
 		static_assert(sizeof(item.data[0]) == value<Width>::chunks * sizeof(chunk_t),
 		              "memory<Width> is not compatible with C layout");
 		type    = MEMORY;
@@ -906,6 +953,42 @@ struct debug_items {
 	}
 };
 
+// State of a module instance in activity-driven mode (see `write_cxxrtl -activity`). An instance is evaluated only
+// if its inputs or its state changed since it was last evaluated; otherwise, the last evaluation result is reused.
+struct activity_tracker {
+	bool dirty = true;
+	bool converged = false;
+	uint64_t evaluated = 0;
+	uint64_t skipped = 0;
+};
+
+// Evaluation counters of the module instances in activity-driven mode, collected by `module::activity_info()`.
+// The counters are kept apart from the debug items, so that they do not show up in waveform dumps. Instances are
+// identified by their hierarchical name with components separated by spaces; the top module is named "".
+struct activity_stats {
+	struct counters {
+		uint64_t evaluated;
+		uint64_t skipped;
+	};
+
+	std::map<std::string, counters> table;
+
+	void add(const std::string &path, const activity_tracker &tracker) {
+		std::string name = path.empty() ? path : path.substr(0, path.size() - 1);
+		table[name] = counters { tracker.evaluated, tracker.skipped };
+	}
+
+	size_t count(const std::string &name) const {
+		return table.count(name);
+	}
+
+	const counters &at(const std::string &name) const {
+		return table.at(name);
+	}
+};
+
+class snapshot;
+
 struct module {
 	module() {}
 	virtual ~module() {}
@@ -929,6 +1012,138 @@ struct module {
 	virtual void debug_info(debug_items &items, std::string path = "") {
 		(void)items, (void)path;
 	}
+
+	// Collects the evaluation counters of the module and its submodules in activity-driven mode.
+	virtual void activity_info(activity_stats &stats, std::string path = "") {
+		(void)stats, (void)path;
+	}
+
+	// Saves the state of the module and its submodules to, or restores it from, a snapshot. Black boxes that have
+	// internal state must override this function to include it in snapshots, and call the generated implementation
+	// to include their ports.
+	virtual void visit_state(snapshot &state) {
+		(void)state;
+	}
+};
+
+// A snapshot of the state of a design (the contents of its wires, memories, and edge detectors) in a contiguous
+// buffer. Snapshots may only be saved or restored between calls to `step()`, and may only be restored into
+// a design of the same type as the one they were saved from.
+//
+// Saving or restoring a snapshot incrementally only copies the memory rows that were written since the previous
+// time the same snapshot was saved or restored, which makes it cheap to periodically update a checkpoint of
+// a design with large memories. Memories modified directly (rather than by the simulation) must be saved or
+// restored non-incrementally afterwards.
+class snapshot {
+	std::vector<chunk_t> data;
+	size_t cursor = 0;
+	size_t id;
+	size_t generation = 0;
+	size_t next_generation = 0;
+	enum {
+		SAVING,
+		RESTORING,
+		MEASURING,
+	} mode = SAVING;
+	bool incremental = false;
+
+	static size_t next_id() {
+		static size_t last_id = 0;
+		return ++last_id;
+	}
+
+	chunk_t *chunks_at(size_t count) {
+		if (mode == SAVING && cursor + count > data.size())
+			data.resize(cursor + count);
+		chunk_t *chunks = data.data() + cursor;
+		cursor += count;
+		return chunks;
+	}
+
+	void copy(chunk_t *state, chunk_t *buffer, size_t count) {
+		if (mode == RESTORING)
+			std::copy(buffer, buffer + count, state);
+		else if (mode == SAVING)
+			std::copy(state, state + count, buffer);
+	}
+
+	void visit(module &top) {
+		cursor = 0;
+		top.visit_state(*this);
+	}
+
+public:
+	snapshot() : id(next_id()) {}
+	snapshot(const snapshot &other) : data(other.data), id(next_id()) {}
+	snapshot &operator=(const snapshot &other) {
+		data = other.data;
+		id = next_id();
+		return *this;
+	}
+
+	void save(module &top, bool incremental = false) {
+		this->mode = SAVING;
+		this->incremental = incremental;
+		next_generation = generation + 1;
+		visit(top);
+		data.resize(cursor);
+		generation = next_generation;
+	}
+
+	// Returns false and leaves the design unchanged if the snapshot was never saved, or was saved from a design with
+	// a different state layout.
+	bool restore(module &top, bool incremental = false) {
+		this->mode = MEASURING;
+		visit(top);
+		if (cursor != data.size())
+			return false;
+		this->mode = RESTORING;
+		this->incremental = incremental;
+		next_generation = generation;
+		visit(top);
+		return true;
+	}
+
+	// The serialized state of the design.
+	const std::vector<chunk_t> &buffer() const {
+		return data;
+	}
+
+	template<size_t Bits>
+	void item(value<Bits> &item) {
+		copy(item.data, chunks_at(value<Bits>::chunks), value<Bits>::chunks);
+	}
+
+	template<size_t Bits>
+	void item(wire<Bits> &item) {
+		copy(item.curr.data, chunks_at(value<Bits>::chunks), value<Bits>::chunks);
+		copy(item.next.data, chunks_at(value<Bits>::chunks), value<Bits>::chunks);
+	}
+
+	template<size_t Width, size_t WritePorts>
+	void item(memory<Width, WritePorts> &item) {
+		const size_t row_chunks = value<Width>::chunks;
+		chunk_t *chunks = chunks_at(item.data.size() * row_chunks);
+		if (mode == MEASURING)
+			return;
+		if (incremental && item.snapshot_id == id && item.snapshot_generation == generation &&
+				!item.dirty_rows.empty()) {
+			for (size_t word = 0; word < item.dirty_rows.size(); word++) {
+				uint64_t rows = item.dirty_rows[word];
+				for (size_t row = word * 64; rows != 0; row++, rows >>= 1)
+					if (rows & 1)
+						copy(item.data[row].data, chunks + row * row_chunks, row_chunks);
+				item.dirty_rows[word] = 0;
+			}
+		} else {
+			for (size_t row = 0; row < item.data.size(); row++)
+				copy(item.data[row].data, chunks + row * row_chunks, row_chunks);
+			if (incremental || !item.dirty_rows.empty())
+				item.dirty_rows.assign((item.data.size() + 63) / 64, 0);
+		}
+		item.snapshot_id = id;
+		item.snapshot_generation = next_generation;
+	}
 };
 
 } // namespace cxxrtl
@@ -1342,9 +1557,26 @@ std::pair<value<BitsY>, value<BitsY>> divmod_uu(const value<BitsA> &a, const val
 	value<Bits> quotient;
 	value<Bits> dividend = a.template zext<Bits>();
 	value<Bits> divisor = b.template zext<Bits>();
+	// Division by zero is undefined in RTLIL; the quotient is all ones, like in most hardware dividers.
+	if (divisor.is_zero())
+		return {/*quotient=*/value<BitsY> {}.bit_not(), /*remainder=*/dividend.template trunc<BitsY>()};
+	if (Bits <= std::numeric_limits<wide_chunk_t>::digits) {
+		// Values that fit into a wide chunk can be divided natively.
+		wide_chunk_t wide_dividend = 0, wide_divisor = 0;
+		for (size_t n = 0; n < value<Bits>::chunks; n++) {
+			wide_dividend |= wide_chunk_t(dividend.data[n]) << (n * value<Bits>::chunk::bits);
+			wide_divisor  |= wide_chunk_t(divisor.data[n])  << (n * value<Bits>::chunk::bits);
+		}
+		wide_chunk_t wide_quotient = wide_dividend / wide_divisor, wide_remainder = wide_dividend % wide_divisor;
+		for (size_t n = 0; n < value<Bits>::chunks; n++) {
+			quotient.data[n] = wide_quotient >> (n * value<Bits>::chunk::bits);
+			dividend.data[n] = wide_remainder >> (n * value<Bits>::chunk::bits);
+		}
+		return {quotient.template trunc<BitsY>(), /*remainder=*/dividend.template trunc<BitsY>()};
+	}
 	if (dividend.ucmp(divisor))
 		return {/*quotient=*/value<BitsY> { 0u }, /*remainder=*/dividend.template trunc<BitsY>()};
-	uint32_t divisor_shift = dividend.ctlz() - divisor.ctlz();
+	uint32_t divisor_shift = divisor.ctlz() - dividend.ctlz();
 	divisor = divisor.shl(value<32> { divisor_shift });
 	for (size_t step = 0; step <= divisor_shift; step++) {
 		quotient = quotient.shl(value<1> { 1u });
@@ -521,6 +521,7 @@ struct CxxrtlWorker {
 	std::string design_ns = "cxxrtl_design";
 	std::ostream *impl_f = nullptr;
 	std::ostream *intf_f = nullptr;
+	std::vector<std::ostream*> extra_impl_fs;
 
 	bool run_flatten = false;
 	bool run_proc = false;
@@ -534,6 +535,9 @@ struct CxxrtlWorker {
 
 	bool debug_info = false;
 
+	bool parallel = false;
+	bool activity = false;
+
 	std::ostringstream f;
 	std::string indent;
 	int temporary = 0;
@@ -551,6 +555,10 @@ struct CxxrtlWorker {
 	dict<const RTLIL::Wire*, RTLIL::Const> debug_const_wires;
 	dict<const RTLIL::Module*, pool<std::string>> blackbox_specializations;
 	dict<const RTLIL::Module*, bool> eval_converges;
+	dict<const RTLIL::Module*, bool> activity_tracked;
+	dict<const RTLIL::Module*, bool> contains_blackbox;
+	dict<const RTLIL::Cell*, size_t> memwr_slots;
+	dict<const RTLIL::Memory*, size_t> memory_write_ports;
 
 	void inc_indent() {
 		indent += "\t";
@@ -1188,11 +1196,12 @@ struct CxxrtlWorker {
 				f << indent << "assert(" << valid_index_temp << ".valid && \"out of bounds write\");\n";
 				f << indent << "if (" << valid_index_temp << ".valid) {\n";
 				inc_indent();
-					f << indent << mangle(memory) << ".update(" << valid_index_temp << ".index, ";
+					f << indent << mangle(memory) << ".update<" << memwr_slots.at(cell) << ">(";
+					f << valid_index_temp << ".index, ";
 					dump_sigspec_rhs(cell->getPort(ID::DATA));
 					f << ", ";
 					dump_sigspec_rhs(cell->getPort(ID::EN));
-					f << ", " << cell->getParam(ID::PRIORITY).as_int() << ");\n";
+					f << ");\n";
 				dec_indent();
 				f << indent << "}\n";
 			}
@@ -1207,73 +1216,166 @@ struct CxxrtlWorker {
 		} else {
 			log_assert(cell->known());
 			const char *access = is_cxxrtl_blackbox_cell(cell) ? "->" : ".";
-			for (auto conn : cell->connections())
-				if (cell->input(conn.first) && !cell->output(conn.first)) {
-					f << indent << mangle(cell) << access << mangle_wire_name(conn.first) << " = ";
-					dump_sigspec_rhs(conn.second);
-					f << ";\n";
-					if (getenv("CXXRTL_VOID_MY_WARRANTY")) {
-						// Until we have proper clock tree detection, this really awful hack that opportunistically
-						// propagates prev_* values for clocks can be used to estimate how much faster a design could
-						// be if only one clock edge was simulated by replacing:
-						//   top.p_clk = value<1>{0u}; top.step();
-						//   top.p_clk = value<1>{1u}; top.step();
-						// with:
-						//   top.prev_p_clk = value<1>{0u}; top.p_clk = value<1>{1u}; top.step();
-						// Don't rely on this; it will be removed without warning.
-						RTLIL::Module *cell_module = cell->module->design->module(cell->type);
-						if (cell_module != nullptr && cell_module->wire(conn.first) && conn.second.is_wire()) {
-							RTLIL::Wire *cell_module_wire = cell_module->wire(conn.first);
-							if (edge_wires[conn.second.as_wire()] && edge_wires[cell_module_wire]) {
-								f << indent << mangle(cell) << access << "prev_" << mangle(cell_module_wire) << " = ";
-								f << "prev_" << mangle(conn.second.as_wire()) << ";\n";
-							}
-						}
-					}
-				} else if (cell->input(conn.first)) {
-					f << indent << mangle(cell) << access << mangle_wire_name(conn.first) << ".next = ";
-					dump_sigspec_rhs(conn.second);
-					f << ";\n";
-				}
-			auto assign_from_outputs = [&](bool cell_converged) {
-				for (auto conn : cell->connections()) {
-					if (cell->output(conn.first)) {
-						if (conn.second.empty())
-							continue; // ignore disconnected ports
-						if (is_cxxrtl_sync_port(cell, conn.first))
-							continue; // fully sync ports are handled in CELL_SYNC nodes
-						f << indent;
-						dump_sigspec_lhs(conn.second);
-						f << " = " << mangle(cell) << access << mangle_wire_name(conn.first);
-						// Similarly to how there is no purpose to buffering cell inputs, there is also no purpose to buffering
-						// combinatorial cell outputs in case the cell converges within one cycle. (To convince yourself that
-						// this optimization is valid, consider that, since the cell converged within one cycle, it would not
-						// have any buffered wires if they were not output ports. Imagine inlining the cell's eval() function,
-						// and consider the fate of the localized wires that used to be output ports.)
-						//
-						// Unlike cell inputs (which are never buffered), it is not possible to know apriori whether the cell
-						// (which may be late bound) will converge immediately. Because of this, the choice between using .curr
-						// (appropriate for buffered outputs) and .next (appropriate for unbuffered outputs) is made at runtime.
-						if (cell_converged && is_cxxrtl_comb_port(cell, conn.first))
-							f << ".next;\n";
-						else
-							f << ".curr;\n";
-					}
-				}
-			};
+			dump_user_cell_inputs(cell);
 			f << indent << "if (" << mangle(cell) << access << "eval()) {\n";
 			inc_indent();
-				assign_from_outputs(/*cell_converged=*/true);
+				dump_user_cell_outputs(cell, /*cell_converged=*/true);
 			dec_indent();
 			f << indent << "} else {\n";
 			inc_indent();
 				f << indent << "converged = false;\n";
-				assign_from_outputs(/*cell_converged=*/false);
+				dump_user_cell_outputs(cell, /*cell_converged=*/false);
 			dec_indent();
 			f << indent << "}\n";
 		}
 	}
 
+	void dump_user_cell_inputs(const RTLIL::Cell *cell)
+	{
+		const char *access = is_cxxrtl_blackbox_cell(cell) ? "->" : ".";
+		for (auto conn : cell->connections())
+			if (cell->input(conn.first) && !cell->output(conn.first)) {
+				f << indent << mangle(cell) << access << mangle_wire_name(conn.first) << " = ";
+				dump_sigspec_rhs(conn.second);
+				f << ";\n";
+				if (getenv("CXXRTL_VOID_MY_WARRANTY")) {
+					// Until we have proper clock tree detection, this really awful hack that opportunistically
+					// propagates prev_* values for clocks can be used to estimate how much faster a design could
+					// be if only one clock edge was simulated by replacing:
+					//   top.p_clk = value<1>{0u}; top.step();
+					//   top.p_clk = value<1>{1u}; top.step();
+					// with:
+					//   top.prev_p_clk = value<1>{0u}; top.p_clk = value<1>{1u}; top.step();
+					// Don't rely on this; it will be removed without warning.
+					RTLIL::Module *cell_module = cell->module->design->module(cell->type);
+					if (cell_module != nullptr && cell_module->wire(conn.first) && conn.second.is_wire()) {
+						RTLIL::Wire *cell_module_wire = cell_module->wire(conn.first);
+						if (edge_wires[conn.second.as_wire()] && edge_wires[cell_module_wire]) {
+							f << indent << mangle(cell) << access << "prev_" << mangle(cell_module_wire) << " = ";
+							f << "prev_" << mangle(conn.second.as_wire()) << ";\n";
+						}
+					}
+				}
+			} else if (cell->input(conn.first)) {
+				f << indent << mangle(cell) << access << mangle_wire_name(conn.first) << ".next = ";
+				dump_sigspec_rhs(conn.second);
+				f << ";\n";
+			}
+	}
+
+	void dump_user_cell_outputs(const RTLIL::Cell *cell, bool cell_converged)
+	{
+		const char *access = is_cxxrtl_blackbox_cell(cell) ? "->" : ".";
+		for (auto conn : cell->connections()) {
+			if (cell->output(conn.first)) {
+				if (conn.second.empty())
+					continue; // ignore disconnected ports
+				if (is_cxxrtl_sync_port(cell, conn.first))
+					continue; // fully sync ports are handled in CELL_SYNC nodes
+				f << indent;
+				dump_sigspec_lhs(conn.second);
+				f << " = " << mangle(cell) << access << mangle_wire_name(conn.first);
+				// Similarly to how there is no purpose to buffering cell inputs, there is also no purpose to buffering
+				// combinatorial cell outputs in case the cell converges within one cycle. (To convince yourself that
+				// this optimization is valid, consider that, since the cell converged within one cycle, it would not
+				// have any buffered wires if they were not output ports. Imagine inlining the cell's eval() function,
+				// and consider the fate of the localized wires that used to be output ports.)
+				//
+				// Unlike cell inputs (which are never buffered), it is not possible to know apriori whether the cell
+				// (which may be late bound) will converge immediately. Because of this, the choice between using .curr
+				// (appropriate for buffered outputs) and .next (appropriate for unbuffered outputs) is made at runtime.
+				if (cell_converged && is_cxxrtl_comb_port(cell, conn.first))
+					f << ".next;\n";
+				else
+					f << ".curr;\n";
+			}
+		}
+	}
+
+	// Black box implementations are user code that may access shared state, so any module that instantiates a black
+	// box, directly or through its submodules, is excluded from parallel evaluation.
+	bool is_blackbox_or_contains_blackbox(RTLIL::Module *module)
+	{
+		if (contains_blackbox.count(module))
+			return contains_blackbox[module];
+
+		bool result = module->get_bool_attribute(ID(cxxrtl_blackbox));
+		for (auto cell : module->cells()) {
+			if (result)
+				break;
+			if (is_internal_cell(cell->type))
+				continue;
+			RTLIL::Module *cell_module = module->design->module(cell->type);
+			log_assert(cell_module != nullptr);
+			result = is_blackbox_or_contains_blackbox(cell_module);
+		}
+		return contains_blackbox[module] = result;
+	}
+
+	// Submodule instances without black boxes only access their own state in eval() and commit(), and so may be
+	// evaluated concurrently as long as none of them has inputs that depend on outputs of another one.
+	bool is_parallel_cell(const RTLIL::Cell *cell)
+	{
+		if (is_internal_cell(cell->type))
+			return false;
+		RTLIL::Module *cell_module = cell->module->design->module(cell->type);
+		log_assert(cell_module != nullptr);
+		return !is_blackbox_or_contains_blackbox(cell_module);
+	}
+
+	void collect_sigspec_rhs_wires(const RTLIL::SigSpec &sig, pool<const RTLIL::Wire*> &wires)
+	{
+		for (auto chunk : sig.chunks()) {
+			if (!chunk.wire)
+				continue;
+			wires.insert(chunk.wire);
+			if (!elided_wires.count(chunk.wire))
+				continue;
+
+			const FlowGraph::Node &node = elided_wires[chunk.wire];
+			switch (node.type) {
+				case FlowGraph::Node::Type::CONNECT:
+					collect_sigspec_rhs_wires(node.connect.second, wires);
+					break;
+				case FlowGraph::Node::Type::CELL_EVAL:
+					for (auto port : node.cell->connections())
+						if (port.first != ID::Y)
+							collect_sigspec_rhs_wires(port.second, wires);
+					break;
+				default:
+					log_assert(false);
+			}
+		}
+	}
+
+	void dump_parallel_cells_eval(const std::vector<const RTLIL::Cell*> &cells)
+	{
+		for (auto cell : cells)
+			dump_user_cell_inputs(cell);
+		f << indent << "{\n";
+		inc_indent();
+			f << indent << "module *const cells[] = {";
+			for (auto cell : cells)
+				f << " &" << mangle(cell) << ",";
+			f << " };\n";
+			f << indent << "bool cells_converged[" << cells.size() << "];\n";
+			f << indent << "worker_pool::global().eval(cells, cells_converged, " << cells.size() << ");\n";
+			for (size_t n = 0; n < cells.size(); n++) {
+				f << indent << "if (cells_converged[" << n << "]) {\n";
+				inc_indent();
+					dump_user_cell_outputs(cells[n], /*cell_converged=*/true);
+				dec_indent();
+				f << indent << "} else {\n";
+				inc_indent();
+					f << indent << "converged = false;\n";
+					dump_user_cell_outputs(cells[n], /*cell_converged=*/false);
+				dec_indent();
+				f << indent << "}\n";
+			}
+		dec_indent();
+		f << indent << "}\n";
+	}
+
 	void dump_assign(const RTLIL::SigSig &sigsig)
 	{
 		f << indent;
@@ -1501,8 +1603,12 @@ struct CxxrtlWorker {
 			return a_prio > b_prio || (a_prio == b_prio && a_addr < b_addr);
 		});
 
+		std::string memory_type = stringf("memory<%d>", memory->width);
+		if (memory_write_ports.count(memory))
+			memory_type = stringf("memory<%d, %zu>", memory->width, memory_write_ports[memory]);
+
 		dump_attrs(memory);
-		f << indent << "memory<" << memory->width << "> " << mangle(memory)
+		f << indent << memory_type << " " << mangle(memory)
 		            << " { " << memory->size << "u";
 		if (init_cells.empty()) {
 			f << " };\n";
@@ -1514,7 +1620,7 @@ struct CxxrtlWorker {
 					RTLIL::Const data = cell->getPort(ID::DATA).as_const();
 					size_t width = cell->getParam(ID::WIDTH).as_int();
 					size_t words = cell->getParam(ID::WORDS).as_int();
-					f << indent << "memory<" << memory->width << ">::init<" << words << "> { "
+					f << indent << memory_type << "::init<" << words << "> { "
 					            << stringf("%#x", cell->getPort(ID::ADDR).as_int()) << ", {";
 					inc_indent();
 						for (size_t n = 0; n < words; n++) {
@@ -1533,9 +1639,52 @@ struct CxxrtlWorker {
 		}
 	}
 
+	// In activity-driven mode, evaluation of a module instance is skipped if none of its inputs or state changed since
+	// it was last evaluated. This is only valid if its evaluation is a function of its inputs and state alone, which
+	// rules out black boxes (these may have arbitrary side effects) and bidirectional ports (these may be driven from
+	// either side between evaluations).
+	bool is_activity_tracked(RTLIL::Module *module)
+	{
+		if (!activity)
+			return false;
+		if (activity_tracked.count(module))
+			return activity_tracked[module];
+
+		bool tracked = !module->get_bool_attribute(ID(cxxrtl_blackbox));
+		for (auto wire : module->wires())
+			if (wire->port_input && wire->port_output)
+				tracked = false;
+		for (auto cell : module->cells()) {
+			if (is_internal_cell(cell->type))
+				continue;
+			RTLIL::Module *cell_module = module->design->module(cell->type);
+			log_assert(cell_module != nullptr);
+			if (!is_activity_tracked(cell_module))
+				tracked = false;
+		}
+		return activity_tracked[module] = tracked;
+	}
+
 	void dump_eval_method(RTLIL::Module *module)
 	{
 		inc_indent();
+			if (is_activity_tracked(module)) {
+				f << indent << "if (!activity.dirty";
+				for (auto wire : module->wires())
+					if (wire->port_input && unbuffered_wires[wire])
+						f << " && " << mangle(wire) << " == activity_" << mangle(wire);
+				f << ") {\n";
+				inc_indent();
+					f << indent << "activity.skipped++;\n";
+					f << indent << "return activity.converged;\n";
+				dec_indent();
+				f << indent << "}\n";
+				f << indent << "activity.evaluated++;\n";
+				f << indent << "activity.dirty = false;\n";
+				for (auto wire : module->wires())
+					if (wire->port_input && unbuffered_wires[wire])
+						f << indent << "activity_" << mangle(wire) << " = " << mangle(wire) << ";\n";
+			}
 			f << indent << "bool converged = " << (eval_converges.at(module) ? "true" : "false") << ";\n";
 			if (!module->get_bool_attribute(ID(cxxrtl_blackbox))) {
 				for (auto wire : module->wires()) {
@@ -1556,7 +1705,44 @@ struct CxxrtlWorker {
 				}
 				for (auto wire : module->wires())
 					dump_wire(wire, /*is_local_context=*/true);
-				for (auto node : schedule[module]) {
+				const std::vector<FlowGraph::Node> &module_schedule = schedule[module];
+				for (size_t n = 0; n < module_schedule.size(); n++) {
+					const FlowGraph::Node &node = module_schedule[n];
+					if (parallel && node.type == FlowGraph::Node::Type::CELL_EVAL && is_parallel_cell(node.cell)) {
+						// Group consecutive submodule instances that do not depend on each other, and evaluate
+						// the group on the worker pool. Inputs of every instance in the group are assigned before
+						// any of them are evaluated, so only instances that do not use any outputs of the earlier
+						// instances in the group may be added to it.
+						std::vector<const RTLIL::Cell*> cells = { node.cell };
+						pool<const RTLIL::Wire*> cells_defs;
+						for (; n + 1 < module_schedule.size(); n++) {
+							const FlowGraph::Node &next_node = module_schedule[n + 1];
+							if (next_node.type != FlowGraph::Node::Type::CELL_EVAL || !is_parallel_cell(next_node.cell))
+								break;
+							for (auto conn : cells.back()->connections())
+								if (cells.back()->output(conn.first))
+									for (auto chunk : conn.second.chunks())
+										if (chunk.wire)
+											cells_defs.insert(chunk.wire);
+							pool<const RTLIL::Wire*> next_uses;
+							for (auto conn : next_node.cell->connections())
+								if (next_node.cell->input(conn.first))
+									collect_sigspec_rhs_wires(conn.second, next_uses);
+							bool is_independent = true;
+							for (auto wire : next_uses)
+								if (cells_defs.count(wire)) {
+									is_independent = false;
+									break;
+								}
+							if (!is_independent)
+								break;
+							cells.push_back(next_node.cell);
+						}
+						if (cells.size() > 1) {
+							dump_parallel_cells_eval(cells);
+							continue;
+						}
+					}
 					switch (node.type) {
 						case FlowGraph::Node::Type::CONNECT:
 							dump_connect(node.connect);
@@ -1573,6 +1759,8 @@ struct CxxrtlWorker {
 					}
 				}
 			}
+			if (is_activity_tracked(module))
+				f << indent << "activity.converged = converged;\n";
 			f << indent << "return converged;\n";
 		dec_indent();
 	}
@@ -1585,8 +1773,12 @@ struct CxxrtlWorker {
 				if (elided_wires.count(wire))
 					continue;
 				if (unbuffered_wires[wire]) {
-					if (edge_wires[wire])
+					if (edge_wires[wire]) {
+						// The edge detectors are a part of the module state that is not reflected in `changed`.
+						if (is_activity_tracked(module))
+							f << indent << "activity.dirty |= prev_" << mangle(wire) << " != " << mangle(wire) << ";\n";
 						f << indent << "prev_" << mangle(wire) << " = " << mangle(wire) << ";\n";
+					}
 					continue;
 				}
 				if (!module->get_bool_attribute(ID(cxxrtl_blackbox)) || wire->port_id != 0)
@@ -1598,17 +1790,94 @@ struct CxxrtlWorker {
 						continue;
 					f << indent << "changed |= " << mangle(memory.second) << ".commit();\n";
 				}
+				std::vector<const RTLIL::Cell*> parallel_cells;
 				for (auto cell : module->cells()) {
 					if (is_internal_cell(cell->type))
 						continue;
+					if (parallel && is_parallel_cell(cell)) {
+						parallel_cells.push_back(cell);
+						continue;
+					}
 					const char *access = is_cxxrtl_blackbox_cell(cell) ? "->" : ".";
 					f << indent << "changed |= " << mangle(cell) << access << "commit();\n";
 				}
+				if (parallel_cells.size() == 1) {
+					f << indent << "changed |= " << mangle(parallel_cells[0]) << ".commit();\n";
+				} else if (parallel_cells.size() > 1) {
+					f << indent << "{\n";
+					inc_indent();
+						f << indent << "module *const cells[] = {";
+						for (auto cell : parallel_cells)
+							f << " &" << mangle(cell) << ",";
+						f << " };\n";
+						f << indent << "bool cells_changed[" << parallel_cells.size() << "];\n";
+						f << indent << "changed |= worker_pool::global().commit(cells, cells_changed, ";
+						f << parallel_cells.size() << ");\n";
+					dec_indent();
+					f << indent << "}\n";
+				}
 			}
+			if (is_activity_tracked(module))
+				f << indent << "activity.dirty |= changed;\n";
 			f << indent << "return changed;\n";
 		dec_indent();
 	}
 
+	void dump_visit_state_method(RTLIL::Module *module)
+	{
+		size_t count_items = 0;
+		inc_indent();
+			for (auto wire : module->wires()) {
+				if (elided_wires.count(wire) || localized_wires.count(wire))
+					continue;
+				if (module->get_bool_attribute(ID(cxxrtl_blackbox)) && wire->port_id == 0)
+					continue;
+				f << indent << "state.item(" << mangle(wire) << ");\n";
+				if (edge_wires[wire] && unbuffered_wires[wire])
+					f << indent << "state.item(prev_" << mangle(wire) << ");\n";
+				count_items++;
+			}
+			for (auto memory : module->memories) {
+				if (!writable_memories[memory.second])
+					continue;
+				f << indent << "state.item(" << mangle(memory.second) << ");\n";
+				count_items++;
+			}
+			for (auto cell : module->cells()) {
+				if (is_internal_cell(cell->type))
+					continue;
+				const char *access = is_cxxrtl_blackbox_cell(cell) ? "->" : ".";
+				f << indent << mangle(cell) << access << "visit_state(state);\n";
+				count_items++;
+			}
+			if (count_items == 0)
+				f << indent << "(void)state;\n";
+			if (is_activity_tracked(module))
+				f << indent << "activity.dirty = true;\n";
+		dec_indent();
+	}
+
+	void dump_activity_info_method(RTLIL::Module *module)
+	{
+		size_t count_items = 0;
+		inc_indent();
+			f << indent << "assert(path.empty() || path[path.size() - 1] == ' ');\n";
+			if (is_activity_tracked(module)) {
+				f << indent << "stats.add(path, activity);\n";
+				count_items++;
+			}
+			for (auto cell : module->cells()) {
+				if (is_internal_cell(cell->type) || is_cxxrtl_blackbox_cell(cell))
+					continue;
+				f << indent << mangle(cell) << ".activity_info(stats, ";
+				f << "path + " << escape_cxx_string(get_hdl_name(cell) + ' ') << ");\n";
+				count_items++;
+			}
+			if (count_items == 0)
+				f << indent << "(void)stats;\n";
+		dec_indent();
+	}
+
 	void dump_debug_info_method(RTLIL::Module *module)
 	{
 		size_t count_public_wires = 0;
@@ -1719,6 +1988,10 @@ struct CxxrtlWorker {
 				dump_commit_method(module);
 				f << indent << "}\n";
 				f << "\n";
+				f << indent << "void visit_state(snapshot &state) override {\n";
+				dump_visit_state_method(module);
+				f << indent << "}\n";
+				f << "\n";
 				if (debug_info) {
 					f << indent << "void debug_info(debug_items &items, std::string path = \"\") override {\n";
 					dump_debug_info_method(module);
@@ -1785,10 +2058,20 @@ struct CxxrtlWorker {
 				}
 				if (has_cells)
 					f << "\n";
+				if (is_activity_tracked(module)) {
+					f << indent << "activity_tracker activity;\n";
+					for (auto wire : module->wires())
+						if (wire->port_input && unbuffered_wires[wire])
+							f << indent << "value<" << wire->width << "> activity_" << mangle(wire) << ";\n";
+					f << "\n";
+				}
 				f << indent << "bool eval() override;\n";
 				f << indent << "bool commit() override;\n";
+				f << indent << "void visit_state(snapshot &state) override;\n";
 				if (debug_info)
 					f << indent << "void debug_info(debug_items &items, std::string path = \"\") override;\n";
+				if (activity)
+					f << indent << "void activity_info(activity_stats &stats, std::string path = \"\") override;\n";
 			dec_indent();
 			f << indent << "}; // struct " << mangle(module) << "\n";
 			f << "\n";
@@ -1807,12 +2090,22 @@ struct CxxrtlWorker {
 		dump_commit_method(module);
 		f << indent << "}\n";
 		f << "\n";
+		f << indent << "void " << mangle(module) << "::visit_state(snapshot &state) {\n";
+		dump_visit_state_method(module);
+		f << indent << "}\n";
+		f << "\n";
 		if (debug_info) {
 			f << indent << "void " << mangle(module) << "::debug_info(debug_items &items, std::string path) {\n";
 			dump_debug_info_method(module);
 			f << indent << "}\n";
 			f << "\n";
 		}
+		if (activity) {
+			f << indent << "void " << mangle(module) << "::activity_info(activity_stats &stats, std::string path) {\n";
+			dump_activity_info_method(module);
+			f << indent << "}\n";
+			f << "\n";
+		}
 	}
 
 	void dump_design(RTLIL::Design *design)
@@ -1869,7 +2162,7 @@ struct CxxrtlWorker {
 			}
 			f << "#ifdef __cplusplus\n";
 			f << "\n";
-			f << "#include <backends/cxxrtl/cxxrtl.h>\n";
+			f << "#include <backends/cxxrtl/" << (parallel ? "cxxrtl_parallel.h" : "cxxrtl.h") << ">\n";
 			f << "\n";
 			f << "using namespace cxxrtl;\n";
 			f << "\n";
@@ -1888,10 +2181,11 @@ struct CxxrtlWorker {
 		if (split_intf)
 			f << "#include \"" << intf_filename << "\"\n";
 		else
-			f << "#include <backends/cxxrtl/cxxrtl.h>\n";
+			f << "#include <backends/cxxrtl/" << (parallel ? "cxxrtl_parallel.h" : "cxxrtl.h") << ">\n";
 		f << "\n";
 		f << "#if defined(CXXRTL_INCLUDE_CAPI_IMPL) || \\\n";
-		f << "    defined(CXXRTL_INCLUDE_VCD_CAPI_IMPL)\n";
+		f << "    defined(CXXRTL_INCLUDE_VCD_CAPI_IMPL) || \\\n";
+		f << "    defined(CXXRTL_INCLUDE_WAVEFORM_CAPI_IMPL)\n";
 		f << "#include <backends/cxxrtl/cxxrtl_capi.cc>\n";
 		f << "#endif\n";
 		f << "\n";
@@ -1899,11 +2193,32 @@ struct CxxrtlWorker {
 		f << "#include <backends/cxxrtl/cxxrtl_vcd_capi.cc>\n";
 		f << "#endif\n";
 		f << "\n";
+		f << "#if defined(CXXRTL_INCLUDE_WAVEFORM_CAPI_IMPL)\n";
+		f << "#include <backends/cxxrtl/cxxrtl_waveform_capi.cc>\n";
+		f << "#endif\n";
+		f << "\n";
 		f << "using namespace cxxrtl_yosys;\n";
 		f << "\n";
 		f << "namespace " << design_ns << " {\n";
 		f << "\n";
-		for (auto module : modules) {
+		// Module implementations may be distributed between several translation units, so that they can be compiled
+		// in parallel. Each module, starting from the largest one, is placed into the least loaded unit.
+		std::vector<std::vector<RTLIL::Module*>> impl_parts(1 + extra_impl_fs.size());
+		std::vector<size_t> impl_part_sizes(impl_parts.size());
+		std::vector<RTLIL::Module*> modules_by_size = modules;
+		std::stable_sort(modules_by_size.begin(), modules_by_size.end(), [](RTLIL::Module *a, RTLIL::Module *b) {
+			return GetSize(a->cells_) + GetSize(a->processes) > GetSize(b->cells_) + GetSize(b->processes);
+		});
+		dict<RTLIL::Module*, size_t> module_parts;
+		for (auto module : modules_by_size) {
+			size_t part = std::min_element(impl_part_sizes.begin(), impl_part_sizes.end()) - impl_part_sizes.begin();
+			module_parts[module] = part;
+			impl_part_sizes[part] += 1 + GetSize(module->cells_) + GetSize(module->processes);
+		}
+		for (auto module : modules)
+			impl_parts[module_parts[module]].push_back(module);
+
+		for (auto module : impl_parts[0]) {
 			if (!split_intf)
 				dump_module_intf(module);
 			dump_module_impl(module);
@@ -1922,6 +2237,19 @@ struct CxxrtlWorker {
 		}
 
 		*impl_f << f.str(); f.str("");
+
+		for (size_t part = 1; part < impl_parts.size(); part++) {
+			f << "#include \"" << intf_filename << "\"\n";
+			f << "\n";
+			f << "using namespace cxxrtl_yosys;\n";
+			f << "\n";
+			f << "namespace " << design_ns << " {\n";
+			f << "\n";
+			for (auto module : impl_parts[part])
+				dump_module_impl(module);
+			f << "} // namespace " << design_ns << "\n";
+			*extra_impl_fs[part - 1] << f.str(); f.str("");
+		}
 	}
 
 	// Edge-type sync rules require us to emit edge detectors, which require coordination between
@@ -2142,6 +2470,23 @@ struct CxxrtlWorker {
 						}
 			}
 
+			// Every write port of a memory is assigned a slot in its write queue. The slots are ordered by priority,
+			// and write ports with the same priority are ordered by evaluation order, the same as in a dynamic queue.
+			dict<const RTLIL::Memory*, std::vector<const RTLIL::Cell*>> memwr_cells;
+			for (auto &node : schedule[module])
+				if (node.type == FlowGraph::Node::Type::CELL_EVAL && node.cell->type == ID($memwr)) {
+					const RTLIL::Memory *memory = module->memories[node.cell->getParam(ID::MEMID).decode_string()];
+					memwr_cells[memory].push_back(node.cell);
+				}
+			for (auto &it : memwr_cells) {
+				std::stable_sort(it.second.begin(), it.second.end(), [](const RTLIL::Cell *a, const RTLIL::Cell *b) {
+					return a->getParam(ID::PRIORITY).as_int() < b->getParam(ID::PRIORITY).as_int();
+				});
+				for (size_t slot = 0; slot < it.second.size(); slot++)
+					memwr_slots[it.second[slot]] = slot;
+				memory_write_ports[it.first] = it.second.size();
+			}
+
 			if (!feedback_wires.empty()) {
 				has_feedback_arcs = true;
 				log("Module `%s' contains feedback arcs through wires:\n", log_id(module));
@@ -2182,7 +2527,16 @@ struct CxxrtlWorker {
 					log("  %s\n", log_id(wire));
 			}
 
-			eval_converges[module] = feedback_wires.empty() && buffered_comb_wires.empty();
+			// Unbuffered combinatorial outputs of the toplevel are computed from the state of the design before it is
+			// committed; if that state changes (e.g. on a clock edge), another delta cycle is required for the outputs
+			// to reflect it once step() returns.
+			bool has_comb_toplevel_outputs = false;
+			if (module->get_bool_attribute(ID::top))
+				for (auto wire : module->wires())
+					if (wire->port_output && unbuffered_wires[wire] && flow.wire_comb_defs[wire].size() > 0)
+						has_comb_toplevel_outputs = true;
+
+			eval_converges[module] = feedback_wires.empty() && buffered_comb_wires.empty() && !has_comb_toplevel_outputs;
 
 			if (debug_info) {
 				// Find wires that alias other wires or are tied to a constant; debug information can be enriched with these
@@ -2470,10 +2824,38 @@ struct CxxrtlBackend : public Backend {
 		log("        of the interface is derived from filename of the implementation.\n");
 		log("        otherwise, interface and implementation are generated together.\n");
 		log("\n");
+		log("    -split <count>\n");
+		log("        distribute the implementation between <count> translation units that\n");
+		log("        can be compiled in parallel. must be used together with -header. the\n");
+		log("        filenames of the additional units are derived from the filename of\n");
+		log("        the implementation by appending a number, e.g. `top_1.cc'. the design\n");
+		log("        is split at module boundaries, so it should not be fully flattened,\n");
+		log("        e.g. use -noflatten or mark some modules (*keep_hierarchy*).\n");
+		log("\n");
 		log("    -namespace <ns-name>\n");
 		log("        place the generated code into namespace <ns-name>. if not specified,\n");
 		log("        \"cxxrtl_design\" is used.\n");
 		log("\n");
+		log("    -parallel\n");
+		log("        evaluate and commit independent submodule instances concurrently on\n");
+		log("        a pool of worker threads. the generated code includes the header\n");
+		log("        `cxxrtl_parallel.h' and must be linked with the thread library. the\n");
+		log("        size of the pool is taken from the CXXRTL_THREADS environment variable,\n");
+		log("        or is the number of hardware threads. only has an effect on designs\n");
+		log("        that are not fully flattened, e.g. with -noflatten or with modules\n");
+		log("        marked (*keep_hierarchy*). the simulation results are identical to\n");
+		log("        those of the single-threaded model. instances that contain black boxes\n");
+		log("        at any depth are always evaluated on the calling thread.\n");
+		log("\n");
+		log("    -activity\n");
+		log("        evaluate a module instance only if its inputs or state changed since\n");
+		log("        it was last evaluated. this is beneficial for designs where large\n");
+		log("        parts are idle, if they are not fully flattened, e.g. with -noflatten\n");
+		log("        or with modules marked (*keep_hierarchy*). modules that contain black\n");
+		log("        boxes or have inout ports are always evaluated. the number of evaluated\n");
+		log("        and skipped evaluations of every instance is available through the\n");
+		log("        activity_info() method of the model.\n");
+		log("\n");
 		log("    -noflatten\n");
 		log("        don't flatten the design. fully flattened designs can evaluate within\n");
 		log("        one delta cycle if they have no combinatorial feedback.\n");
@@ -2534,6 +2916,7 @@ struct CxxrtlBackend : public Backend {
 		bool noproc = false;
 		int opt_level = DEFAULT_OPT_LEVEL;
 		int debug_level = DEFAULT_DEBUG_LEVEL;
+		int split_count = 1;
 		CxxrtlWorker worker;
 
 		log_header(design, "Executing CXXRTL backend.\n");
@@ -2582,6 +2965,18 @@ struct CxxrtlBackend : public Backend {
 				worker.design_ns = args[++argidx];
 				continue;
 			}
+			if (args[argidx] == "-split" && argidx+1 < args.size()) {
+				split_count = std::stoi(args[++argidx]);
+				continue;
+			}
+			if (args[argidx] == "-parallel") {
+				worker.parallel = true;
+				continue;
+			}
+			if (args[argidx] == "-activity") {
+				worker.activity = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
@@ -2637,6 +3032,24 @@ struct CxxrtlBackend : public Backend {
 
 			worker.intf_f = &intf_f;
 		}
+		if (split_count < 1)
+			log_cmd_error("Invalid number of translation units %d.\n", split_count);
+		std::vector<std::unique_ptr<std::ofstream>> extra_impl_fs;
+		if (split_count > 1) {
+			if (!worker.split_intf)
+				log_cmd_error("Option -split must be used together with -header.\n");
+
+			std::string stem = filename.substr(0, filename.rfind('.'));
+			std::string extension = filename.substr(stem.size());
+			for (int part = 1; part < split_count; part++) {
+				std::string part_filename = stringf("%s_%d%s", stem.c_str(), part, extension.c_str());
+				extra_impl_fs.emplace_back(new std::ofstream(part_filename, std::ofstream::trunc));
+				if (extra_impl_fs.back()->fail())
+					log_cmd_error("Can't open file `%s' for writing: %s\n",
+					              part_filename.c_str(), strerror(errno));
+				worker.extra_impl_fs.push_back(extra_impl_fs.back().get());
+			}
+		}
 		worker.impl_f = f;
 
 		worker.prepare_design(design);
@@ -0,0 +1,88 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// This file is included by drivers that simulate many independent instances of a design generated with
+// `write_cxxrtl`, e.g. with different stimulus for regression testing or fuzzing. It is not used in Yosys itself.
+//
+// The instances (lanes) of a batch are stepped in lockstep: every delta cycle evaluates and commits all lanes that
+// have not yet settled one after another, which keeps the code of the design hot in the instruction cache. Each lane
+// settles after exactly as many delta cycles as it would when stepped on its own, so the results are identical to
+// those of independently stepped instances.
+
+#ifndef CXXRTL_BATCH_H
+#define CXXRTL_BATCH_H
+
+#include <array>
+#include <string>
+
+#include <backends/cxxrtl/cxxrtl.h>
+
+namespace cxxrtl {
+
+template<class Module, size_t Lanes>
+class batch {
+	static_assert(Lanes > 0, "batch must have at least one lane");
+
+	std::array<Module, Lanes> lanes;
+
+public:
+	static constexpr size_t size() {
+		return Lanes;
+	}
+
+	// Per-lane stimulus and inspection is performed through the instance of each lane.
+	Module &lane(size_t index) {
+		return lanes.at(index);
+	}
+
+	const Module &lane(size_t index) const {
+		return lanes.at(index);
+	}
+
+	// Returns the largest number of delta cycles any lane required to settle.
+	size_t step() {
+		std::array<Module*, Lanes> active;
+		size_t active_count = Lanes;
+		for (size_t index = 0; index < Lanes; index++)
+			active[index] = &lanes[index];
+
+		size_t deltas = 0;
+		while (active_count > 0) {
+			size_t next_count = 0;
+			for (size_t index = 0; index < active_count; index++) {
+				Module *instance = active[index];
+				bool converged = instance->eval();
+				if (instance->commit() && !converged)
+					active[next_count++] = instance;
+			}
+			active_count = next_count;
+			deltas++;
+		}
+		return deltas;
+	}
+
+	// Lane `n` appears in the hierarchy as `lane_<n>`.
+	void debug_info(debug_items &items, std::string path = "") {
+		for (size_t index = 0; index < Lanes; index++)
+			lanes[index].debug_info(items, path + "lane_" + std::to_string(index) + " ");
+	}
+};
+
+}
+
+#endif
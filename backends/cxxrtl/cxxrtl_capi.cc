@@ -61,3 +61,28 @@ void cxxrtl_enum(cxxrtl_handle handle, void *data,
 	for (auto &it : handle->objects.table)
 		callback(data, it.first.c_str(), static_cast<cxxrtl_object*>(&it.second[0]), it.second.size());
 }
+
+struct _cxxrtl_snapshot {
+	cxxrtl::snapshot snapshot;
+};
+
+cxxrtl_snapshot cxxrtl_snapshot_create() {
+	return new _cxxrtl_snapshot;
+}
+
+void cxxrtl_snapshot_destroy(cxxrtl_snapshot snapshot) {
+	delete snapshot;
+}
+
+void cxxrtl_snapshot_save(cxxrtl_snapshot snapshot, cxxrtl_handle handle, int incremental) {
+	snapshot->snapshot.save(*handle->module, incremental);
+}
+
+int cxxrtl_snapshot_restore(cxxrtl_snapshot snapshot, cxxrtl_handle handle, int incremental) {
+	return snapshot->snapshot.restore(*handle->module, incremental);
+}
+
+const uint32_t *cxxrtl_snapshot_data(cxxrtl_snapshot snapshot, size_t *chunks) {
+	*chunks = snapshot->snapshot.buffer().size();
+	return snapshot->snapshot.buffer().data();
+}
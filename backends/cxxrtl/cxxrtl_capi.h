@@ -178,6 +178,41 @@ void cxxrtl_enum(cxxrtl_handle handle, void *data,
                  void (*callback)(void *data, const char *name,
                                   struct cxxrtl_object *object, size_t parts));
 
+// Opaque reference to a design state snapshot.
+//
+// A snapshot contains the state of a design (its wires, memories, and edge detectors) and can be
+// used to return the design to the point in time when the snapshot was saved.
+typedef struct _cxxrtl_snapshot *cxxrtl_snapshot;
+
+// Create an empty snapshot.
+cxxrtl_snapshot cxxrtl_snapshot_create(void);
+
+// Release all resources used by a snapshot.
+void cxxrtl_snapshot_destroy(cxxrtl_snapshot snapshot);
+
+// Save the state of a design to a snapshot.
+//
+// Snapshots can only be saved between calls to `cxxrtl_step`. If `incremental` is non-zero, only
+// memory rows written by the simulation since the last time this snapshot was saved or restored
+// are copied. Memories modified through `cxxrtl_object` must be saved non-incrementally.
+void cxxrtl_snapshot_save(cxxrtl_snapshot snapshot, cxxrtl_handle handle, int incremental);
+
+// Restore the state of a design from a snapshot.
+//
+// The snapshot must have been saved from a design of the same type. Snapshots can only be restored
+// between calls to `cxxrtl_step`. The meaning of `incremental` is the same as for
+// `cxxrtl_snapshot_save`.
+//
+// Returns 1 if the state was restored, or 0 if the snapshot was never saved or was saved from
+// a design with a different state layout; in that case the design is left unchanged.
+int cxxrtl_snapshot_restore(cxxrtl_snapshot snapshot, cxxrtl_handle handle, int incremental);
+
+// Retrieve the contents of a snapshot, e.g. to write it to a file.
+//
+// Returns the chunks in the snapshot and writes their number to `chunks`. The returned chunks are
+// valid until the snapshot is saved to again or destroyed.
+const uint32_t *cxxrtl_snapshot_data(cxxrtl_snapshot snapshot, size_t *chunks);
+
 #ifdef __cplusplus
 }
 #endif
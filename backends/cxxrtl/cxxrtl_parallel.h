@@ -0,0 +1,170 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// This file is included by the designs generated with `write_cxxrtl -parallel`. It is not used in Yosys itself.
+//
+// The parallel evaluation support library provides a persistent pool of worker threads that the generated code
+// uses to evaluate and commit independent submodule instances concurrently. Each dispatch is a barrier: it returns
+// only once every instance has been evaluated (or committed), so the eval/commit phases of the simulation keep
+// exactly the same ordering as in the single-threaded model, and the results are bit-exact.
+//
+// A pool serves one dispatch at a time. Models simulated on several threads at once share the global pool; while it
+// is busy with a dispatch from one of them, the others evaluate (or commit) their instances on their own thread.
+
+#ifndef CXXRTL_PARALLEL_H
+#define CXXRTL_PARALLEL_H
+
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <backends/cxxrtl/cxxrtl.h>
+
+namespace cxxrtl {
+
+class worker_pool {
+	std::vector<std::thread> threads;
+	std::mutex dispatch_mutex;
+	std::mutex mutex;
+	std::condition_variable work_ready, work_done;
+	size_t generation = 0;
+	size_t busy = 0;
+	bool stopping = false;
+
+	module *const *job_modules = nullptr;
+	bool *job_results = nullptr;
+	size_t job_count = 0;
+	bool job_commit = false;
+	std::atomic<size_t> job_next { 0 };
+
+	// Modules dispatched to the pool may contain submodules that are dispatched to the pool themselves. Nested
+	// dispatches are not parallelized; the outer dispatch already keeps every thread busy.
+	static bool &in_dispatch() {
+		static thread_local bool flag = false;
+		return flag;
+	}
+
+	void work() {
+		size_t index;
+		while ((index = job_next.fetch_add(1, std::memory_order_relaxed)) < job_count)
+			job_results[index] = job_commit ? job_modules[index]->commit() : job_modules[index]->eval();
+	}
+
+	void worker() {
+		in_dispatch() = true;
+		size_t seen_generation = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			work_ready.wait(lock, [&] { return stopping || generation != seen_generation; });
+			if (stopping)
+				return;
+			seen_generation = generation;
+			lock.unlock();
+			work();
+			lock.lock();
+			if (--busy == 0)
+				work_done.notify_one();
+		}
+	}
+
+	void run(module *const *modules, bool *results, size_t count, bool commit) {
+		// Held for the whole dispatch, since the job below is shared by every thread of the pool.
+		std::unique_lock<std::mutex> dispatch(dispatch_mutex, std::defer_lock);
+		if (threads.empty() || count < 2 || in_dispatch() || !dispatch.try_lock()) {
+			for (size_t index = 0; index < count; index++)
+				results[index] = commit ? modules[index]->commit() : modules[index]->eval();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job_modules = modules;
+			job_results = results;
+			job_count = count;
+			job_commit = commit;
+			job_next.store(0, std::memory_order_relaxed);
+			busy = threads.size();
+			generation++;
+		}
+		work_ready.notify_all();
+
+		in_dispatch() = true;
+		work();
+		in_dispatch() = false;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		work_done.wait(lock, [&] { return busy == 0; });
+	}
+
+public:
+	// The calling thread participates in every dispatch, so a pool of `size` threads spawns `size - 1` workers.
+	explicit worker_pool(size_t size) {
+		for (size_t index = 1; index < size; index++)
+			threads.emplace_back(&worker_pool::worker, this);
+	}
+
+	~worker_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		work_ready.notify_all();
+		for (auto &thread : threads)
+			thread.join();
+	}
+
+	worker_pool(const worker_pool &) = delete;
+	worker_pool &operator=(const worker_pool &) = delete;
+
+	size_t size() const {
+		return threads.size() + 1;
+	}
+
+	// Evaluates `count` modules that do not depend on each other; `results[n]` receives `modules[n]->eval()`.
+	void eval(module *const *modules, bool *results, size_t count) {
+		run(modules, results, count, /*commit=*/false);
+	}
+
+	// Commits `count` modules, using `results` as scratch space; returns true if any of them changed.
+	bool commit(module *const *modules, bool *results, size_t count) {
+		bool changed = false;
+		run(modules, results, count, /*commit=*/true);
+		for (size_t index = 0; index < count; index++)
+			changed |= results[index];
+		return changed;
+	}
+
+	// The pool used by the generated code. Its size is taken from the `CXXRTL_THREADS` environment variable if it
+	// is set, and is the number of hardware threads otherwise.
+	static worker_pool &global() {
+		static worker_pool pool(default_size());
+		return pool;
+	}
+
+	static size_t default_size() {
+		if (const char *threads = std::getenv("CXXRTL_THREADS"))
+			return std::max(std::atoi(threads), 1);
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+};
+
+}
+
+#endif
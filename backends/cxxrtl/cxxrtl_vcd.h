@@ -102,10 +102,30 @@ class vcd_writer {
 
 	void emit_vector(const variable &var) {
 		assert(streaming);
+		// A zero-width variable has no bits to emit, and `var.width - 1` below would wrap around.
+		if (var.width == 0)
+			return;
+		const size_t chunk_bits = 8 * sizeof(chunk_t);
 		buffer += 'b';
-		for (size_t bit = var.width - 1; bit != (size_t)-1; bit--) {
-			bool bit_curr = var.curr[bit / (8 * sizeof(chunk_t))] & (1 << (bit % (8 * sizeof(chunk_t))));
+		// Emit the bits above the highest nibble boundary one at a time, and the rest four at a time.
+		size_t bit = var.width - 1;
+		for (; bit % 4 != 3; bit--) {
+			bool bit_curr = var.curr[bit / chunk_bits] & ((chunk_t)1 << (bit % chunk_bits));
 			buffer += (bit_curr ? '1' : '0');
+			if (bit == 0)
+				break;
+		}
+		if (bit % 4 == 3) {
+			static const char nibbles[16][4] = {
+				{'0','0','0','0'}, {'0','0','0','1'}, {'0','0','1','0'}, {'0','0','1','1'},
+				{'0','1','0','0'}, {'0','1','0','1'}, {'0','1','1','0'}, {'0','1','1','1'},
+				{'1','0','0','0'}, {'1','0','0','1'}, {'1','0','1','0'}, {'1','0','1','1'},
+				{'1','1','0','0'}, {'1','1','0','1'}, {'1','1','1','0'}, {'1','1','1','1'},
+			};
+			for (size_t nibble = bit / 4; nibble != (size_t)-1; nibble--) {
+				size_t lsb = nibble * 4;
+				buffer.append(nibbles[(var.curr[lsb / chunk_bits] >> (lsb % chunk_bits)) & 0xf], 4);
+			}
 		}
 		buffer += ' ';
 		emit_ident(var.ident);
@@ -229,7 +249,7 @@ public:
 			emit_enddefinitions();
 		}
 		emit_time(timestamp);
-		for (auto var : variables)
+		for (auto &var : variables)
 			if (test_variable(var) || first_sample) {
 				if (var.width == 1)
 					emit_scalar(var);
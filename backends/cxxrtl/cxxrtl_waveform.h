@@ -0,0 +1,395 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// This file is included by simulation drivers that record waveforms in the compact binary format described below.
+// It is not used in Yosys itself.
+//
+// The waveform writer records the same variables and samples as `vcd_writer`, with the same interface, but instead of
+// formatting text for every changed variable it appends the changed chunks, XORed with their previous values, to
+// a block as variable-length words. Every block begins with a frame containing the values of all variables, so
+// blocks can be decoded independently of each other. `waveform_to_vcd` converts a waveform to exactly the VCD file
+// that `vcd_writer` would have written for the same variables and samples.
+//
+// In the format, every number is an unsigned LEB128 varint, and a string is its length followed by its bytes:
+//
+//   waveform    := "CXXRTLW\x01" header block*
+//   header      := timescale-number timescale-unit variable-count width{variable-count}
+//                  declaration-count declaration{declaration-count}
+//   declaration := type width lsb-at depth multipart constant name variable{depth}
+//   block       := sample-count first-timestamp payload-size frame sample{sample-count - 1}
+//   frame       := word{chunks} for every variable
+//   sample      := timestamp-delta change* 0
+//   change      := variable-delta word{chunks}
+//
+// A timescale number of 0 means that the timescale was not set. A declaration corresponds to a call to `add()`;
+// a non-memory declaration has a depth of 1. The frame holds the values at the first timestamp of the block. In
+// a sample, the variables that changed since the previous sample are listed in ascending order; `variable-delta` is
+// the difference between the index of the variable and the one of the previously listed variable (or -1) in the same
+// sample, and the words are the chunks of the variable XORed with their previous values.
+
+#ifndef CXXRTL_WAVEFORM_H
+#define CXXRTL_WAVEFORM_H
+
+#include <istream>
+#include <ostream>
+
+#include <backends/cxxrtl/cxxrtl_vcd.h>
+
+namespace cxxrtl {
+
+class waveform_writer {
+	struct variable {
+		size_t width;
+		size_t chunks;
+		chunk_t *curr;
+		size_t prev_off;
+	};
+
+	std::vector<variable> variables;
+	std::vector<chunk_t> cache;
+	std::map<chunk_t*, size_t> aliases;
+	std::string declarations;
+	size_t declaration_count = 0;
+	unsigned timescale_number = 0;
+	std::string timescale_unit;
+	bool streaming = false;
+
+	std::string block;
+	size_t block_samples = 0;
+	uint64_t block_timestamp = 0;
+	uint64_t last_timestamp = 0;
+
+	static void emit_number(std::string &out, uint64_t number) {
+		while (number >= 0x80) {
+			out += (char)(number | 0x80);
+			number >>= 7;
+		}
+		out += (char)number;
+	}
+
+	static void emit_string(std::string &out, const std::string &str) {
+		emit_number(out, str.size());
+		out += str;
+	}
+
+	void emit_header() {
+		assert(!streaming);
+		buffer.append("CXXRTLW\x01", 8);
+		emit_number(buffer, timescale_number);
+		emit_string(buffer, timescale_unit);
+		emit_number(buffer, variables.size());
+		for (auto &var : variables)
+			emit_number(buffer, var.width);
+		emit_number(buffer, declaration_count);
+		buffer += declarations;
+		declarations.clear();
+		streaming = true;
+	}
+
+	void emit_frame() {
+		for (auto &var : variables)
+			for (size_t n = 0; n < var.chunks; n++) {
+				emit_number(block, var.curr[n]);
+				if (var.prev_off != (size_t)-1)
+					cache[var.prev_off + n] = var.curr[n];
+			}
+	}
+
+	void emit_changes() {
+		size_t next_index = 0;
+		for (size_t index = 0; index < variables.size(); index++) {
+			const variable &var = variables[index];
+			if (var.prev_off == (size_t)-1)
+				continue; // constant
+			chunk_t *prev = &cache[var.prev_off];
+			if (std::equal(&var.curr[0], &var.curr[var.chunks], prev))
+				continue;
+			emit_number(block, index + 1 - next_index);
+			next_index = index + 1;
+			for (size_t n = 0; n < var.chunks; n++) {
+				emit_number(block, var.curr[n] ^ prev[n]);
+				prev[n] = var.curr[n];
+			}
+		}
+		block += '\0';
+	}
+
+	size_t register_variable(size_t width, chunk_t *curr, bool constant = false) {
+		if (aliases.count(curr)) {
+			return aliases[curr];
+		} else {
+			const size_t chunks = (width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+			aliases[curr] = variables.size();
+			if (constant) {
+				variables.emplace_back(variable { width, chunks, curr, (size_t)-1 });
+			} else {
+				variables.emplace_back(variable { width, chunks, curr, cache.size() });
+				cache.insert(cache.end(), &curr[0], &curr[chunks]);
+			}
+			return variables.size() - 1;
+		}
+	}
+
+public:
+	std::string buffer;
+
+	// Blocks are completed once they are at least this large, or when `flush()` is called.
+	size_t block_size = 1 << 20;
+
+	void timescale(unsigned number, const std::string &unit) {
+		assert(!streaming);
+		assert(number == 1 || number == 10 || number == 100);
+		assert(unit == "s" || unit == "ms" || unit == "us" ||
+		       unit == "ns" || unit == "ps" || unit == "fs");
+		timescale_number = number;
+		timescale_unit = unit;
+	}
+
+	void add(const std::string &hier_name, const debug_item &item, bool multipart = false) {
+		assert(!streaming);
+		bool constant = item.type == debug_item::VALUE && item.next == nullptr;
+		emit_number(declarations, item.type);
+		emit_number(declarations, item.width);
+		emit_number(declarations, item.lsb_at);
+		if (item.type == debug_item::MEMORY) {
+			const size_t stride = (item.width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+			emit_number(declarations, item.depth);
+			emit_number(declarations, multipart);
+			emit_number(declarations, constant);
+			emit_string(declarations, hier_name);
+			for (size_t index = 0; index < item.depth; index++)
+				emit_number(declarations, register_variable(item.width, &item.curr[stride * index]));
+		} else {
+			emit_number(declarations, 1);
+			emit_number(declarations, multipart);
+			emit_number(declarations, constant);
+			emit_string(declarations, hier_name);
+			emit_number(declarations, register_variable(item.width, item.curr, constant));
+		}
+		declaration_count++;
+	}
+
+	template<class Filter>
+	void add(const debug_items &items, const Filter &filter) {
+		for (auto &it : items.table)
+			for (auto &part : it.second)
+				if (filter(it.first, part))
+					add(it.first, part, it.second.size() > 1);
+	}
+
+	void add(const debug_items &items) {
+		this->template add(items, [](const std::string &, const debug_item &) {
+			return true;
+		});
+	}
+
+	void add_without_memories(const debug_items &items) {
+		this->template add(items, [](const std::string &, const debug_item &item) {
+			return item.type != debug_item::MEMORY;
+		});
+	}
+
+	void sample(uint64_t timestamp) {
+		if (!streaming)
+			emit_header();
+		if (block_samples == 0) {
+			block_timestamp = timestamp;
+			emit_frame();
+		} else {
+			assert(timestamp >= last_timestamp);
+			emit_number(block, timestamp - last_timestamp);
+			emit_changes();
+		}
+		last_timestamp = timestamp;
+		block_samples++;
+		if (block.size() >= block_size)
+			flush();
+	}
+
+	// Appends the current block, if any, to `buffer`. The next sample starts a new block.
+	void flush() {
+		if (block_samples == 0)
+			return;
+		emit_number(buffer, block_samples);
+		emit_number(buffer, block_timestamp);
+		emit_number(buffer, block.size());
+		buffer += block;
+		block.clear();
+		block_samples = 0;
+	}
+};
+
+// Converts a waveform written by `waveform_writer` from `in` to VCD, written to `out`. The waveform is read one block
+// at a time. Returns false if the waveform is malformed or truncated.
+inline bool waveform_to_vcd(std::istream &in, std::ostream &out) {
+	auto read_number = [&](uint64_t &number) {
+		number = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			int byte = in.get();
+			if (byte == EOF)
+				return false;
+			number |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	};
+	auto read_string = [&](std::string &str) {
+		uint64_t size;
+		if (!read_number(size) || size > (1 << 20))
+			return false;
+		str.resize(size);
+		return (bool)in.read(&str[0], size);
+	};
+
+	char magic[8];
+	if (!in.read(magic, 8) || std::string(magic, 8) != std::string("CXXRTLW\x01", 8))
+		return false;
+
+	vcd_writer vcd;
+	uint64_t timescale_number;
+	std::string timescale_unit;
+	if (!read_number(timescale_number) || !read_string(timescale_unit))
+		return false;
+	if (timescale_number != 0)
+		vcd.timescale(timescale_number, timescale_unit);
+
+	// Every variable is given storage once, by the first declaration that refers to it, so that the VCD writer
+	// unifies the same variables as it would have in the design.
+	uint64_t variable_count;
+	if (!read_number(variable_count))
+		return false;
+	std::vector<size_t> chunks;
+	for (uint64_t index = 0; index < variable_count; index++) {
+		uint64_t width;
+		if (!read_number(width))
+			return false;
+		chunks.push_back((width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8));
+	}
+	std::vector<chunk_t*> locations(variable_count);
+	std::vector<std::unique_ptr<chunk_t[]>> storage;
+
+	uint64_t declaration_count;
+	if (!read_number(declaration_count))
+		return false;
+	for (uint64_t index = 0; index < declaration_count; index++) {
+		uint64_t type, width, lsb_at, depth, multipart, constant;
+		std::string name;
+		if (!read_number(type) || !read_number(width) || !read_number(lsb_at) || !read_number(depth) ||
+		    !read_number(multipart) || !read_number(constant) || !read_string(name))
+			return false;
+		if (type > debug_item::ALIAS || (type != debug_item::MEMORY && depth != 1) || depth > variable_count)
+			return false;
+		const size_t stride = (width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+		::cxxrtl_object object = {};
+		object.type = type;
+		object.width = width;
+		object.lsb_at = lsb_at;
+		object.depth = depth;
+		for (uint64_t row = 0; row < depth; row++) {
+			uint64_t variable;
+			if (!read_number(variable) || variable >= variable_count || chunks[variable] != stride)
+				return false;
+			if (row == 0) {
+				if (locations[variable] == nullptr) {
+					storage.emplace_back(new chunk_t[std::max<size_t>(stride * depth, 1)]());
+					object.curr = storage.back().get();
+				} else {
+					object.curr = locations[variable];
+				}
+			}
+			if (locations[variable] == nullptr)
+				locations[variable] = &object.curr[stride * row];
+			else if (locations[variable] != &object.curr[stride * row])
+				return false;
+		}
+		object.next = constant ? nullptr : object.curr;
+		vcd.add(name, debug_item(object), multipart);
+	}
+
+	auto apply = [&](uint64_t variable, const char *&data, const char *end, bool frame) {
+		for (size_t n = 0; n < chunks[variable]; n++) {
+			uint64_t word = 0;
+			for (unsigned shift = 0; ; shift += 7) {
+				if (data == end || shift >= 64)
+					return false;
+				uint8_t byte = *data++;
+				word |= (uint64_t)(byte & 0x7f) << shift;
+				if (!(byte & 0x80))
+					break;
+			}
+			chunk_t *curr = locations[variable];
+			curr[n] = frame ? (chunk_t)word : curr[n] ^ (chunk_t)word;
+		}
+		return true;
+	};
+	auto decode_number = [](uint64_t &number, const char *&data, const char *end) {
+		number = 0;
+		for (unsigned shift = 0; shift < 64; shift += 7) {
+			if (data == end)
+				return false;
+			uint8_t byte = *data++;
+			number |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	};
+
+	std::string payload;
+	while (in.peek() != EOF) {
+		uint64_t sample_count, timestamp, payload_size;
+		if (!read_number(sample_count) || !read_number(timestamp) || !read_number(payload_size) || sample_count == 0)
+			return false;
+		payload.resize(payload_size);
+		if (!in.read(&payload[0], payload_size))
+			return false;
+		const char *data = payload.data(), *end = payload.data() + payload.size();
+		for (uint64_t variable = 0; variable < variable_count; variable++)
+			if (!apply(variable, data, end, /*frame=*/true))
+				return false;
+		vcd.sample(timestamp);
+		for (uint64_t sample = 1; sample < sample_count; sample++) {
+			uint64_t delta;
+			if (!decode_number(delta, data, end))
+				return false;
+			timestamp += delta;
+			uint64_t variable = (uint64_t)-1;
+			while (true) {
+				if (!decode_number(delta, data, end))
+					return false;
+				if (delta == 0)
+					break;
+				variable += delta;
+				if (variable >= variable_count || !apply(variable, data, end, /*frame=*/false))
+					return false;
+			}
+			vcd.sample(timestamp);
+		}
+		if (data != end)
+			return false;
+		out << vcd.buffer;
+		vcd.buffer.clear();
+	}
+	out << vcd.buffer;
+	return (bool)out;
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+// This file is a part of the CXXRTL C API. It should be used together with `cxxrtl_waveform_capi.h`.
+
+#include <fstream>
+
+#include <backends/cxxrtl/cxxrtl_waveform.h>
+#include <backends/cxxrtl/cxxrtl_waveform_capi.h>
+
+extern const cxxrtl::debug_items &cxxrtl_debug_items_from_handle(cxxrtl_handle handle);
+
+struct _cxxrtl_waveform {
+	cxxrtl::waveform_writer writer;
+	bool flush = false;
+};
+
+cxxrtl_waveform cxxrtl_waveform_create(void) {
+	return new _cxxrtl_waveform;
+}
+
+void cxxrtl_waveform_destroy(cxxrtl_waveform waveform) {
+	delete waveform;
+}
+
+void cxxrtl_waveform_timescale(cxxrtl_waveform waveform, int number, const char *unit) {
+	waveform->writer.timescale(number, unit);
+}
+
+void cxxrtl_waveform_block_size(cxxrtl_waveform waveform, size_t size) {
+	waveform->writer.block_size = size;
+}
+
+void cxxrtl_waveform_add(cxxrtl_waveform waveform, const char *name, cxxrtl_object *object) {
+	// See `cxxrtl_vcd_add` for why the object is copied.
+	waveform->writer.add(name, cxxrtl::debug_item(*object));
+}
+
+void cxxrtl_waveform_add_from(cxxrtl_waveform waveform, cxxrtl_handle handle) {
+	waveform->writer.add(cxxrtl_debug_items_from_handle(handle));
+}
+
+void cxxrtl_waveform_add_from_if(cxxrtl_waveform waveform, cxxrtl_handle handle, void *data,
+                                 int (*filter)(void *data, const char *name,
+                                               const cxxrtl_object *object)) {
+	waveform->writer.add(cxxrtl_debug_items_from_handle(handle),
+		[=](const std::string &name, const cxxrtl::debug_item &item) {
+			return filter(data, name.c_str(), static_cast<const cxxrtl_object*>(&item));
+		});
+}
+
+void cxxrtl_waveform_add_from_without_memories(cxxrtl_waveform waveform, cxxrtl_handle handle) {
+	waveform->writer.add_without_memories(cxxrtl_debug_items_from_handle(handle));
+}
+
+void cxxrtl_waveform_sample(cxxrtl_waveform waveform, uint64_t time) {
+	if (waveform->flush) {
+		waveform->writer.buffer.clear();
+		waveform->flush = false;
+	}
+	waveform->writer.sample(time);
+}
+
+void cxxrtl_waveform_flush(cxxrtl_waveform waveform) {
+	if (waveform->flush) {
+		waveform->writer.buffer.clear();
+		waveform->flush = false;
+	}
+	waveform->writer.flush();
+}
+
+void cxxrtl_waveform_read(cxxrtl_waveform waveform, const char **data, size_t *size) {
+	if (waveform->flush) {
+		waveform->writer.buffer.clear();
+		waveform->flush = false;
+	}
+	*data = waveform->writer.buffer.c_str();
+	*size = waveform->writer.buffer.size();
+	waveform->flush = true;
+}
+
+int cxxrtl_waveform_to_vcd(const char *waveform_path, const char *vcd_path) {
+	std::ifstream in(waveform_path, std::ios::binary);
+	if (!in)
+		return 0;
+	std::ofstream out(vcd_path, std::ios::binary);
+	if (!out)
+		return 0;
+	return cxxrtl::waveform_to_vcd(in, out);
+}
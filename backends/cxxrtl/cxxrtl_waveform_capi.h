@@ -0,0 +1,119 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+#ifndef CXXRTL_WAVEFORM_CAPI_H
+#define CXXRTL_WAVEFORM_CAPI_H
+
+// This file is a part of the CXXRTL C API. It should be used together with `cxxrtl_waveform_capi.cc`.
+//
+// The CXXRTL C API for waveform writing is the counterpart of the VCD writing API for the compact binary waveform
+// format described in `cxxrtl_waveform.h`. Waveforms in this format can be converted to Value Change Dump files
+// with `cxxrtl_waveform_to_vcd`.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <backends/cxxrtl/cxxrtl_capi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque reference to a waveform writer.
+typedef struct _cxxrtl_waveform *cxxrtl_waveform;
+
+// Create a waveform writer.
+cxxrtl_waveform cxxrtl_waveform_create(void);
+
+// Release all resources used by a waveform writer.
+void cxxrtl_waveform_destroy(cxxrtl_waveform waveform);
+
+// Set waveform timescale.
+//
+// The `number` must be 1, 10, or 100, and the `unit` must be one of `"s"`, `"ms"`, `"us"`, `"ns"`,
+// `"ps"`, or `"fs"`.
+//
+// Timescale can only be set before the first call to `cxxrtl_waveform_sample`.
+void cxxrtl_waveform_timescale(cxxrtl_waveform waveform, int number, const char *unit);
+
+// Set the size in bytes after which a block is completed.
+//
+// Every block begins with the values of all scheduled objects, so smaller blocks make the waveform larger, and
+// larger blocks make `cxxrtl_waveform_read` return data less often.
+void cxxrtl_waveform_block_size(cxxrtl_waveform waveform, size_t size);
+
+// Schedule a specific CXXRTL object to be sampled.
+//
+// See `cxxrtl_vcd_add` for details.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_waveform_sample`.
+void cxxrtl_waveform_add(cxxrtl_waveform waveform, const char *name, struct cxxrtl_object *object);
+
+// Schedule all CXXRTL objects in a simulation.
+//
+// The design `handle` must outlive the waveform writer.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_waveform_sample`.
+void cxxrtl_waveform_add_from(cxxrtl_waveform waveform, cxxrtl_handle handle);
+
+// Schedule CXXRTL objects in a simulation that match a given predicate.
+//
+// See `cxxrtl_vcd_add_from_if` for details.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_waveform_sample`.
+void cxxrtl_waveform_add_from_if(cxxrtl_waveform waveform, cxxrtl_handle handle, void *data,
+                                 int (*filter)(void *data, const char *name,
+                                               const struct cxxrtl_object *object));
+
+// Schedule all CXXRTL objects in a simulation except for memories.
+//
+// The design `handle` must outlive the waveform writer.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_waveform_sample`.
+void cxxrtl_waveform_add_from_without_memories(cxxrtl_waveform waveform, cxxrtl_handle handle);
+
+// Sample all scheduled objects.
+//
+// The values of every signal changed since the previous call to `cxxrtl_waveform_sample` are recorded in the current
+// block. Once the block is large enough, it is written to the internal buffer. The contents of the buffer can be
+// retrieved with `cxxrtl_waveform_read`.
+void cxxrtl_waveform_sample(cxxrtl_waveform waveform, uint64_t time);
+
+// Write the current block, if any, to the internal buffer.
+//
+// This function should be called after the last call to `cxxrtl_waveform_sample`, since otherwise the samples
+// recorded since the last completed block are never written.
+void cxxrtl_waveform_flush(cxxrtl_waveform waveform);
+
+// Retrieve buffered waveform data.
+//
+// See `cxxrtl_vcd_read` for details; the data is valid until the next call to `cxxrtl_waveform_sample`,
+// `cxxrtl_waveform_flush`, or `cxxrtl_waveform_read`.
+void cxxrtl_waveform_read(cxxrtl_waveform waveform, const char **data, size_t *size);
+
+// Convert a waveform file to a VCD file.
+//
+// The waveform is read from the file at `waveform_path`, and the VCD file that a VCD writer would have written
+// for the same objects and samples is written to the file at `vcd_path`. Returns 1 on success, and 0 if either
+// file cannot be opened, or the waveform is malformed or truncated.
+int cxxrtl_waveform_to_vcd(const char *waveform_path, const char *vcd_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
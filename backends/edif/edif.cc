@@ -88,6 +88,13 @@ struct EdifNames
 	}
 };
 
+struct EdifNetRef
+{
+	int net, member;
+	bool is_driver;
+	RTLIL::IdString port, instance;
+};
+
 struct EdifBackend : public Backend {
 	EdifBackend() : Backend("edif", "write design to EDIF netlist file") { }
 	void help() YS_OVERRIDE
@@ -337,7 +344,27 @@ struct EdifBackend : public Backend {
 				continue;
 
 			SigMap sigmap(module);
-			std::map<RTLIL::SigSpec, std::set<std::pair<std::string, bool>>> net_join_db;
+			idict<RTLIL::SigBit> net_ids;
+			std::vector<EdifNetRef> net_refs;
+
+			// module ports have an empty instance name, scalar ports a member index of -1
+			auto add_net_ref = [&](RTLIL::SigBit bit, RTLIL::IdString port, int member, RTLIL::IdString instance, bool is_driver) {
+				EdifNetRef ref;
+				ref.net = net_ids(bit);
+				ref.member = member;
+				ref.is_driver = is_driver;
+				ref.port = port;
+				ref.instance = instance;
+				net_refs.push_back(ref);
+			};
+
+			auto net_ref_str = [&](const EdifNetRef &ref) {
+				if (ref.instance.empty())
+					return ref.member < 0 ? stringf("(portRef %s)", EDIF_REF(ref.port)) :
+							stringf("(portRef (member %s %d))", EDIF_REF(ref.port), ref.member);
+				return ref.member < 0 ? stringf("(portRef %s (instanceRef %s))", EDIF_REF(ref.port), EDIF_REF(ref.instance)) :
+						stringf("(portRef (member %s %d) (instanceRef %s))", EDIF_REF(ref.port), ref.member, EDIF_REF(ref.instance));
+			};
 
 			*f << stringf("    (cell %s\n", EDIF_DEF(module->name));
 			*f << stringf("      (cellType GENERIC)\n");
@@ -423,8 +450,7 @@ struct EdifBackend : public Backend {
 						for (auto &p : wire->attributes)
 							add_prop(p.first, p.second);
 					*f << ")\n";
-					RTLIL::SigSpec sig = sigmap(RTLIL::SigSpec(wire));
-					net_join_db[sig].insert(make_pair(stringf("(portRef %s)", EDIF_REF(wire->name)), wire->port_input));
+					add_net_ref(sigmap(RTLIL::SigBit(wire)), wire->name, -1, RTLIL::IdString(), wire->port_input);
 				} else {
 					int b[2];
 					b[wire->upto ? 0 : 1] = wire->start_offset;
@@ -435,10 +461,8 @@ struct EdifBackend : public Backend {
 							add_prop(p.first, p.second);
 
 					*f << ")\n";
-					for (int i = 0; i < wire->width; i++) {
-						RTLIL::SigSpec sig = sigmap(RTLIL::SigSpec(wire, i));
-						net_join_db[sig].insert(make_pair(stringf("(portRef (member %s %d))", EDIF_REF(wire->name), GetSize(wire)-i-1), wire->port_input));
-					}
+					for (int i = 0; i < wire->width; i++)
+						add_net_ref(sigmap(RTLIL::SigBit(wire, i)), wire->name, GetSize(wire)-i-1, RTLIL::IdString(), wire->port_input);
 				}
 			}
 
@@ -463,42 +487,68 @@ struct EdifBackend : public Backend {
 				*f << stringf(")\n");
 				for (auto &p : cell->connections()) {
 					RTLIL::SigSpec sig = sigmap(p.second);
+					bool is_output = cell->output(p.first);
+					int width = sig.size();
+					auto m = design->module(cell->type);
+					if (m) {
+						auto w = m->wire(p.first);
+						if (w)
+							width = GetSize(w);
+					}
+					bool port_named = false;
 					for (int i = 0; i < GetSize(sig); i++)
 						if (sig[i].wire == NULL && sig[i] != RTLIL::State::S0 && sig[i] != RTLIL::State::S1)
 							log_warning("Bit %d of cell port %s.%s.%s driven by %s will be left unconnected in EDIF output.\n",
 									i, log_id(module), log_id(cell), log_id(p.first), log_signal(sig[i]));
 						else {
-							int member_idx = GetSize(sig)-i-1;
-							auto m = design->module(cell->type);
-							int width = sig.size();
-							if (m) {
-								auto w = m->wire(p.first);
-								if (w) {
-									member_idx = GetSize(w)-i-1;
-									width = GetSize(w);
-								}
-							}
-							if (width == 1)
-								net_join_db[sig[i]].insert(make_pair(stringf("(portRef %s (instanceRef %s))", EDIF_REF(p.first), EDIF_REF(cell->name)), cell->output(p.first)));
-							else {
-								net_join_db[sig[i]].insert(make_pair(stringf("(portRef (member %s %d) (instanceRef %s))",
-										EDIF_REF(p.first), member_idx, EDIF_REF(cell->name)), cell->output(p.first)));
-							}
+							// allocate the EDIF name of the port now, so that generated
+							// names are numbered in the order the ports are visited
+							if (!port_named)
+								EDIF_REF(p.first);
+							port_named = true;
+							add_net_ref(sig[i], p.first, width == 1 ? -1 : width-i-1, cell->name, is_output);
 						}
 				}
 			}
 
-			for (auto &it : net_join_db) {
-				RTLIL::SigBit sig = it.first;
+			// group the references by net; within a net they are listed sorted and
+			// without duplicates, and the nets are emitted in SigSpec order
+			std::sort(net_refs.begin(), net_refs.end(), [](const EdifNetRef &a, const EdifNetRef &b) { return a.net < b.net; });
+			std::vector<int> net_begin(GetSize(net_ids)+1, GetSize(net_refs));
+			for (int i = GetSize(net_refs)-1; i >= 0; i--)
+				net_begin[net_refs[i].net] = i;
+
+			auto get_net_refs = [&](int net) {
+				std::vector<std::pair<std::string, bool>> refs;
+				for (int i = net_begin[net]; i < net_begin[net+1]; i++)
+					refs.push_back(make_pair(net_ref_str(net_refs[i]), net_refs[i].is_driver));
+				std::sort(refs.begin(), refs.end());
+				refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
+				return refs;
+			};
+
+			std::vector<std::pair<unsigned int, int>> net_order;
+			net_order.reserve(GetSize(net_ids));
+			for (int i = 0; i < GetSize(net_ids); i++)
+				net_order.push_back(make_pair(RTLIL::SigSpec(net_ids[i]).hash(), i));
+			std::sort(net_order.begin(), net_order.end(), [&](const std::pair<unsigned int, int> &a, const std::pair<unsigned int, int> &b) {
+				if (a.first != b.first)
+					return a.first < b.first;
+				return RTLIL::SigSpec(net_ids[a.second]) < RTLIL::SigSpec(net_ids[b.second]);
+			});
+
+			for (auto &it : net_order) {
+				RTLIL::SigBit sig = net_ids[it.second];
+				std::vector<std::pair<std::string, bool>> refs = get_net_refs(it.second);
 				if (sig.wire == NULL && sig != RTLIL::State::S0 && sig != RTLIL::State::S1) {
 					if (sig == RTLIL::State::Sx) {
-						for (auto &ref : it.second)
+						for (auto &ref : refs)
 							log_warning("Exporting x-bit on %s as zero bit.\n", ref.first.c_str());
 						sig = RTLIL::State::S0;
 					} else if (sig == RTLIL::State::Sz) {
 						continue;
 					} else {
-						for (auto &ref : it.second)
+						for (auto &ref : refs)
 							log_error("Don't know how to handle %s on %s.\n", log_signal(sig), ref.first.c_str());
 						log_abort();
 					}
@@ -515,7 +565,7 @@ struct EdifBackend : public Backend {
 							netname.erase(netname.begin() + i--);
 				}
 				*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
-				for (auto &ref : it.second)
+				for (auto &ref : refs)
 					*f << stringf("              %s\n", ref.first.c_str());
 				if (sig.wire == NULL) {
 					if (nogndvcc)
@@ -542,7 +592,7 @@ struct EdifBackend : public Backend {
 					SigBit raw_sig = RTLIL::SigSpec(wire, i);
 					SigBit mapped_sig = sigmap(raw_sig);
 
-					if (raw_sig == mapped_sig || net_join_db.count(mapped_sig) == 0)
+					if (raw_sig == mapped_sig || net_ids.count(mapped_sig) == 0)
 						continue;
 
 					std::string netname = log_signal(raw_sig);
@@ -554,7 +604,7 @@ struct EdifBackend : public Backend {
 					{
 						*f << stringf("          (net %s (joined\n", EDIF_DEF(netname));
 
-						auto &refs = net_join_db.at(mapped_sig);
+						auto refs = get_net_refs(net_ids.at(mapped_sig));
 						for (auto &ref : refs)
 							if (ref.second)
 								*f << stringf("              %s\n", ref.first.c_str());
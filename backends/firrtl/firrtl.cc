@@ -242,11 +242,33 @@ struct FirrtlWorker
 	{
 	}
 
-	static string make_expr(const SigSpec &sig)
+	// Concatenate parts given LSB first into cat(pN, cat(..., cat(p1, p0)))
+	static string make_cat(const vector<string> &parts)
 	{
+		if (parts.empty())
+			return string();
+
+		size_t len = parts.size() * 7;
+		for (auto &part : parts)
+			len += part.size();
+
 		string expr;
+		expr.reserve(len);
+		for (int i = GetSize(parts)-1; i > 0; i--) {
+			expr += "cat(";
+			expr += parts[i];
+			expr += ", ";
+		}
+		expr += parts[0];
+		expr.append(parts.size()-1, ')');
+		return expr;
+	}
+
+	static string make_expr(const SigSpec &sig)
+	{
+		vector<string> parts;
 
-		for (auto chunk : sig.chunks())
+		for (auto &chunk : sig.chunks())
 		{
 			string new_expr;
 
@@ -280,13 +302,10 @@ struct FirrtlWorker
 				new_expr = stringf("bits(%s, %d, %d)", wire_id.c_str(), chunk.offset + chunk.width - 1, chunk.offset);
 			}
 
-			if (expr.empty())
-				expr = new_expr;
-			else
-				expr = "cat(" + new_expr + ", " + expr + ")";
+			parts.push_back(std::move(new_expr));
 		}
 
-		return expr;
+		return make_cat(parts);
 	}
 
 	std::string fid(RTLIL::IdString internal_id)
@@ -993,7 +1012,7 @@ struct FirrtlWorker
 
 		for (auto wire : module->wires())
 		{
-			string expr;
+			vector<string> parts;
 			std::string wireFileinfo = getFileinfo(wire);
 
 			if (wire->port_input)
@@ -1043,11 +1062,7 @@ struct FirrtlWorker
 					new_expr = unconn_id;
 				}
 
-				if (expr.empty())
-					expr = new_expr;
-				else
-					expr = "cat(" + new_expr + ", " + expr + ")";
-
+				parts.push_back(std::move(new_expr));
 				cursor += chunk_width;
 			}
 
@@ -1059,6 +1074,7 @@ struct FirrtlWorker
 					// a specific line of verilog code.
 					wire_decls.push_back(stringf("    %s is invalid\n", unconn_id.c_str()));
 				}
+				string expr = make_cat(parts);
 				wire_exprs.push_back(stringf("    %s <= %s %s\n", make_id(wire->name), expr.c_str(), wireFileinfo.c_str()));
 			} else {
 				if (make_unconn_id) {
@@ -1071,18 +1087,18 @@ struct FirrtlWorker
 			}
 		}
 
-		for (auto str : port_decls)
+		for (auto &str : port_decls)
 			f << str;
 
 		f << stringf("\n");
 
-		for (auto str : wire_decls)
+		for (auto &str : wire_decls)
 			f << str;
 
 		f << stringf("\n");
 
 		// If we have any memory definitions, output them.
-		for (auto kv : memories) {
+		for (auto &kv : memories) {
 			memory &m = kv.second;
 			f << stringf("    mem %s:\n", m.name.c_str());
 			f << stringf("      data-type => UInt<%d>\n", m.width);
@@ -1099,12 +1115,12 @@ struct FirrtlWorker
 		}
 		f << stringf("\n");
 
-		for (auto str : cell_exprs)
+		for (auto &str : cell_exprs)
 			f << str;
 
 		f << stringf("\n");
 
-		for (auto str : wire_exprs)
+		for (auto &str : wire_exprs)
 			f << str;
 
 		f << stringf("\n");
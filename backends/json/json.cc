@@ -40,7 +40,8 @@ struct JsonWriter
 
 	SigMap sigmap;
 	int sigidcounter;
-	dict<SigBit, string> sigids;
+	dict<Wire*, int> wire_bits_offset;
+	vector<int> sigids;
 	pool<Aig> aig_models;
 
 	JsonWriter(std::ostream &f, bool use_selection, bool aig_mode, bool compat_int_mode) :
@@ -70,17 +71,18 @@ struct JsonWriter
 		for (auto bit : sigmap(sig)) {
 			str += first ? " " : ", ";
 			first = false;
-			if (sigids.count(bit) == 0) {
-				string &s = sigids[bit];
-				if (bit.wire == nullptr) {
-					if (bit == State::S0) s = "\"0\"";
-					else if (bit == State::S1) s = "\"1\"";
-					else if (bit == State::Sz) s = "\"z\"";
-					else s = "\"x\"";
-				} else
-					s = stringf("%d", sigidcounter++);
+			if (bit.wire == nullptr) {
+				if (bit == State::S0) str += "\"0\"";
+				else if (bit == State::S1) str += "\"1\"";
+				else if (bit == State::Sz) str += "\"z\"";
+				else str += "\"x\"";
+				continue;
 			}
-			str += sigids[bit];
+			// ids start at 2, so 0 marks a bit that has not been numbered yet
+			int &id = sigids[wire_bits_offset.at(bit.wire) + bit.offset];
+			if (id == 0)
+				id = sigidcounter++;
+			str += std::to_string(id);
 		}
 		return str + " ]";
 	}
@@ -130,7 +132,16 @@ struct JsonWriter
 		module = module_;
 		log_assert(module->design == design);
 		sigmap.set(module);
-		sigids.clear();
+
+		// net ids are assigned on first use, indexed by the position of
+		// each bit in the concatenation of all wires of the module
+		int num_bits = 0;
+		wire_bits_offset.clear();
+		for (auto w : module->wires()) {
+			wire_bits_offset[w] = num_bits;
+			num_bits += w->width;
+		}
+		sigids.assign(num_bits, 0);
 
 		// reserve 0 and 1 to avoid confusion with "0" and "1"
 		sigidcounter = 2;
@@ -151,6 +151,7 @@ struct HierDirtyFlags
 struct SimplecWorker
 {
 	bool verbose = false;
+	bool bitparallel = false;
 	int max_uintsize = 32;
 
 	Design *design;
@@ -180,8 +181,18 @@ struct SimplecWorker
 	{
 	}
 
+	// suffix for type and function names in -bitparallel mode, so that the
+	// generated code can be used next to the regular model of the design
+	string suffix() const
+	{
+		return bitparallel ? "_x64" : "";
+	}
+
 	string sigtype(int n)
 	{
+		if (bitparallel)
+			return sigtype_bitparallel(n);
+
 		string struct_name = stringf("signal%d_t", n);
 
 		if (generated_sigtypes.count(n) == 0)
@@ -211,6 +222,27 @@ struct SimplecWorker
 		return struct_name;
 	}
 
+	// In -bitparallel mode each bit of a signal is a 64-bit word, and bit k of
+	// that word belongs to the k-th of 64 independently simulated instances.
+	string sigtype_bitparallel(int n)
+	{
+		string struct_name = stringf("signal%d_x64_t", n);
+
+		if (generated_sigtypes.count(n) == 0)
+		{
+			signal_declarations.push_back("");
+			signal_declarations.push_back(stringf("#ifndef YOSYS_SIMPLEC_SIGNAL%d_X64_T", n));
+			signal_declarations.push_back(stringf("#define YOSYS_SIMPLEC_SIGNAL%d_X64_T", n));
+			signal_declarations.push_back(stringf("typedef struct {"));
+			signal_declarations.push_back(stringf("  uint64_t bits[%d];", n));
+			signal_declarations.push_back(stringf("} signal%d_x64_t;", n));
+			signal_declarations.push_back(stringf("#endif"));
+			generated_sigtypes.insert(n);
+		}
+
+		return struct_name;
+	}
+
 	void util_ifdef_guard(string s)
 	{
 		for (int i = 0; i < GetSize(s); i++)
@@ -224,6 +256,9 @@ struct SimplecWorker
 
 	string util_get_bit(const string &signame, int n, int idx)
 	{
+		if (bitparallel)
+			return stringf("%s.bits[%d]", signame.c_str(), idx);
+
 		if (n == 1 && idx == 0)
 			return signame + ".value_0_0";
 
@@ -250,6 +285,9 @@ struct SimplecWorker
 
 	string util_set_bit(const string &signame, int n, int idx, const string &expr)
 	{
+		if (bitparallel)
+			return stringf("  %s.bits[%d] = %s;", signame.c_str(), idx, expr.c_str());
+
 		if (n == 1 && idx == 0)
 			return stringf("  %s.value_0_0 = %s;", signame.c_str(), expr.c_str());
 
@@ -282,6 +320,34 @@ struct SimplecWorker
 		return stringf("  %s(&%s, %s);", util_name.c_str(), signame.c_str(), expr.c_str());
 	}
 
+	string util_const(bool value)
+	{
+		if (bitparallel)
+			return value ? "~(uint64_t)0" : "(uint64_t)0";
+		return value ? "true" : "false";
+	}
+
+	string util_get_expr(HierDirtyFlags *work, SigBit bit)
+	{
+		if (bit.wire == nullptr) {
+			if (bitparallel)
+				return util_const(bit.data != State::S0);
+			return bit.data ? "1" : "0";
+		}
+		return util_get_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset);
+	}
+
+	// the gate expressions below use '!' for negation, which must become a
+	// bitwise '~' when operating on 64 lanes at once
+	string util_gate_expr(string expr)
+	{
+		if (bitparallel)
+			for (auto &ch : expr)
+				if (ch == '!')
+					ch = '~';
+		return expr;
+	}
+
 	void create_module_struct(Module *mod)
 	{
 		if (generated_structs.count(mod->name))
@@ -339,7 +405,7 @@ struct SimplecWorker
 		for (int i = 0; i < GetSize(topo.sorted); i++)
 			topoidx[mod->cell(topo.sorted[i])] = i;
 
-		string ifdef_name = stringf("yosys_simplec_%s_state_t", cid(mod->name).c_str());
+		string ifdef_name = stringf("yosys_simplec_%s%s_state_t", cid(mod->name).c_str(), suffix().c_str());
 
 		for (int i = 0; i < GetSize(ifdef_name); i++)
 			if ('a' <= ifdef_name[i] && ifdef_name[i] <= 'z')
@@ -348,7 +414,7 @@ struct SimplecWorker
 		struct_declarations.push_back("");
 		struct_declarations.push_back(stringf("#ifndef %s", ifdef_name.c_str()));
 		struct_declarations.push_back(stringf("#define %s", ifdef_name.c_str()));
-		struct_declarations.push_back(stringf("struct %s_state_t", cid(mod->name).c_str()));
+		struct_declarations.push_back(stringf("struct %s%s_state_t", cid(mod->name).c_str(), suffix().c_str()));
 		struct_declarations.push_back("{");
 
 		struct_declarations.push_back("  // Input Ports");
@@ -370,7 +436,7 @@ struct SimplecWorker
 
 		for (Cell *c : mod->cells())
 			if (design->module(c->type))
-				struct_declarations.push_back(stringf("  struct %s_state_t %s; // %s", cid(c->type).c_str(), cid(c->name).c_str(), log_id(c)));
+				struct_declarations.push_back(stringf("  struct %s%s_state_t %s; // %s", cid(c->type).c_str(), suffix().c_str(), cid(c->name).c_str(), log_id(c)));
 
 		struct_declarations.push_back(stringf("};"));
 		struct_declarations.push_back("#endif");
@@ -383,14 +449,14 @@ struct SimplecWorker
 			SigBit a = sigmaps.at(work->module)(cell->getPort(ID::A));
 			SigBit y = sigmaps.at(work->module)(cell->getPort(ID::Y));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
+			string a_expr = util_get_expr(work, a);
 			string expr;
 
 			if (cell->type == ID($_BUF_))  expr = a_expr;
 			if (cell->type == ID($_NOT_))  expr = "!" + a_expr;
 
 			log_assert(y.wire);
-			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, expr) +
+			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, util_gate_expr(expr)) +
 					stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
 
 			work->set_dirty(y);
@@ -403,8 +469,8 @@ struct SimplecWorker
 			SigBit b = sigmaps.at(work->module)(cell->getPort(ID::B));
 			SigBit y = sigmaps.at(work->module)(cell->getPort(ID::Y));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
+			string a_expr = util_get_expr(work, a);
+			string b_expr = util_get_expr(work, b);
 			string expr;
 
 			if (cell->type == ID($_AND_))    expr = stringf("%s & %s",    a_expr.c_str(), b_expr.c_str());
@@ -417,7 +483,7 @@ struct SimplecWorker
 			if (cell->type == ID($_ORNOT_))  expr = stringf("%s | (!%s)", a_expr.c_str(), b_expr.c_str());
 
 			log_assert(y.wire);
-			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, expr) +
+			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, util_gate_expr(expr)) +
 					stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
 
 			work->set_dirty(y);
@@ -431,16 +497,16 @@ struct SimplecWorker
 			SigBit c = sigmaps.at(work->module)(cell->getPort(ID::C));
 			SigBit y = sigmaps.at(work->module)(cell->getPort(ID::Y));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data ? "1" : "0";
+			string a_expr = util_get_expr(work, a);
+			string b_expr = util_get_expr(work, b);
+			string c_expr = util_get_expr(work, c);
 			string expr;
 
 			if (cell->type == ID($_AOI3_)) expr = stringf("!((%s & %s) | %s)", a_expr.c_str(), b_expr.c_str(), c_expr.c_str());
 			if (cell->type == ID($_OAI3_)) expr = stringf("!((%s | %s) & %s)", a_expr.c_str(), b_expr.c_str(), c_expr.c_str());
 
 			log_assert(y.wire);
-			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, expr) +
+			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, util_gate_expr(expr)) +
 					stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
 
 			work->set_dirty(y);
@@ -455,17 +521,17 @@ struct SimplecWorker
 			SigBit d = sigmaps.at(work->module)(cell->getPort(ID::D));
 			SigBit y = sigmaps.at(work->module)(cell->getPort(ID::Y));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string c_expr = c.wire ? util_get_bit(work->prefix + cid(c.wire->name), c.wire->width, c.offset) : c.data ? "1" : "0";
-			string d_expr = d.wire ? util_get_bit(work->prefix + cid(d.wire->name), d.wire->width, d.offset) : d.data ? "1" : "0";
+			string a_expr = util_get_expr(work, a);
+			string b_expr = util_get_expr(work, b);
+			string c_expr = util_get_expr(work, c);
+			string d_expr = util_get_expr(work, d);
 			string expr;
 
 			if (cell->type == ID($_AOI4_)) expr = stringf("!((%s & %s) | (%s & %s))", a_expr.c_str(), b_expr.c_str(), c_expr.c_str(), d_expr.c_str());
 			if (cell->type == ID($_OAI4_)) expr = stringf("!((%s | %s) & (%s | %s))", a_expr.c_str(), b_expr.c_str(), c_expr.c_str(), d_expr.c_str());
 
 			log_assert(y.wire);
-			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, expr) +
+			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, util_gate_expr(expr)) +
 					stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
 
 			work->set_dirty(y);
@@ -479,17 +545,24 @@ struct SimplecWorker
 			SigBit s = sigmaps.at(work->module)(cell->getPort(ID::S));
 			SigBit y = sigmaps.at(work->module)(cell->getPort(ID::Y));
 
-			string a_expr = a.wire ? util_get_bit(work->prefix + cid(a.wire->name), a.wire->width, a.offset) : a.data ? "1" : "0";
-			string b_expr = b.wire ? util_get_bit(work->prefix + cid(b.wire->name), b.wire->width, b.offset) : b.data ? "1" : "0";
-			string s_expr = s.wire ? util_get_bit(work->prefix + cid(s.wire->name), s.wire->width, s.offset) : s.data ? "1" : "0";
+			string a_expr = util_get_expr(work, a);
+			string b_expr = util_get_expr(work, b);
+			string s_expr = util_get_expr(work, s);
 
-			// casts to bool are a workaround for CBMC bug (https://github.com/diffblue/cbmc/issues/933)
-			string expr = stringf("%s ? %s(bool)%s : %s(bool)%s", s_expr.c_str(),
-					cell->type == ID($_NMUX_) ? "!" : "", b_expr.c_str(),
-					cell->type == ID($_NMUX_) ? "!" : "", a_expr.c_str());
+			string expr;
+
+			if (bitparallel) {
+				expr = stringf("%s((%s & %s) | (~%s & %s))", cell->type == ID($_NMUX_) ? "~" : "",
+						s_expr.c_str(), b_expr.c_str(), s_expr.c_str(), a_expr.c_str());
+			} else {
+				// casts to bool are a workaround for CBMC bug (https://github.com/diffblue/cbmc/issues/933)
+				expr = stringf("%s ? %s(bool)%s : %s(bool)%s", s_expr.c_str(),
+						cell->type == ID($_NMUX_) ? "!" : "", b_expr.c_str(),
+						cell->type == ID($_NMUX_) ? "!" : "", a_expr.c_str());
+			}
 
 			log_assert(y.wire);
-			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, expr) +
+			funct_declarations.push_back(util_set_bit(work->prefix + cid(y.wire->name), y.wire->width, y.offset, util_gate_expr(expr)) +
 					stringf(" // %s (%s)", log_id(cell), log_id(cell->type)));
 
 			work->set_dirty(y);
@@ -636,7 +709,7 @@ struct SimplecWorker
 		reactivated_cells.clear();
 
 		funct_declarations.push_back("");
-		funct_declarations.push_back(stringf("static void %s(struct %s_state_t *state)", func_name.c_str(), cid(work->module->name).c_str()));
+		funct_declarations.push_back(stringf("static void %s(struct %s%s_state_t *state)", func_name.c_str(), cid(work->module->name).c_str(), suffix().c_str()));
 		funct_declarations.push_back("{");
 		for (auto &line : preamble)
 			funct_declarations.push_back(line);
@@ -662,7 +735,7 @@ struct SimplecWorker
 				for (int i = 0; i < GetSize(sig); i++)
 					if (val[i] == State::S0 || val[i] == State::S1) {
 						SigBit bit = sig[i];
-						preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, val == State::S1 ? "true" : "false"));
+						preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, util_const(val == State::S1)));
 						work->set_dirty(bit);
 					}
 			}
@@ -672,7 +745,7 @@ struct SimplecWorker
 				SigBit val = sigmaps.at(module)(bit);
 
 				if (val == State::S0 || val == State::S1)
-					preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, val == State::S1 ? "true" : "false"));
+					preamble.push_back(util_set_bit(work->prefix + cid(bit.wire->name), bit.wire->width, bit.offset, util_const(val == State::S1)));
 
 				if (driven_bits.at(module).count(val) == 0)
 					work->set_dirty(val);
@@ -690,7 +763,7 @@ struct SimplecWorker
 	{
 		vector<string> preamble;
 		eval_init(work, preamble);
-		make_func(work, cid(work->module->name) + "_init", preamble);
+		make_func(work, cid(work->module->name) + suffix() + "_init", preamble);
 	}
 
 	void make_eval_func(HierDirtyFlags *work)
@@ -704,7 +777,7 @@ struct SimplecWorker
 					work->set_dirty(bit);
 		}
 
-		make_func(work, cid(work->module->name) + "_eval", preamble);
+		make_func(work, cid(work->module->name) + suffix() + "_eval", preamble);
 	}
 
 	void make_tick_func(HierDirtyFlags* /* work */)
@@ -712,6 +785,56 @@ struct SimplecWorker
 		// FIXME
 	}
 
+	// accessors for packing test vectors into and out of the 64 lanes of a
+	// -bitparallel model, ports wider than 64 bits use arrays of uint64_t
+	void make_lane_funcs(HierDirtyFlags *work)
+	{
+		Module *mod = work->module;
+		string state_type = stringf("struct %s%s_state_t", cid(mod->name).c_str(), suffix().c_str());
+
+		for (Wire *w : mod->wires())
+		{
+			if (!w->port_input && !w->port_output)
+				continue;
+
+			string func_prefix = cid(mod->name) + suffix();
+			string signame = "state->" + cid(w->name);
+			bool wide = w->width > 64;
+
+			if (w->port_input) {
+				funct_declarations.push_back("");
+				funct_declarations.push_back(stringf("static inline void %s_set_%s(%s *state, int lane, %s value)",
+						func_prefix.c_str(), cid(w->name).c_str(), state_type.c_str(), wide ? "const uint64_t *" : "uint64_t"));
+				funct_declarations.push_back("{");
+				funct_declarations.push_back(stringf("  for (int i = 0; i < %d; i++)", w->width));
+				funct_declarations.push_back(stringf("    %s.bits[i] = (%s.bits[i] & ~((uint64_t)1 << lane)) | (((%s >> %s) & 1) << lane);",
+						signame.c_str(), signame.c_str(), wide ? "value[i / 64]" : "value", wide ? "(i % 64)" : "i"));
+				funct_declarations.push_back("}");
+			}
+
+			funct_declarations.push_back("");
+			if (wide)
+				funct_declarations.push_back(stringf("static inline void %s_get_%s(const %s *state, int lane, uint64_t *value)",
+						func_prefix.c_str(), cid(w->name).c_str(), state_type.c_str()));
+			else
+				funct_declarations.push_back(stringf("static inline uint64_t %s_get_%s(const %s *state, int lane)",
+						func_prefix.c_str(), cid(w->name).c_str(), state_type.c_str()));
+			funct_declarations.push_back("{");
+			if (wide) {
+				funct_declarations.push_back(stringf("  for (int i = 0; i < %d; i++)", (w->width + 63) / 64));
+				funct_declarations.push_back("    value[i] = 0;");
+				funct_declarations.push_back(stringf("  for (int i = 0; i < %d; i++)", w->width));
+				funct_declarations.push_back(stringf("    value[i / 64] |= ((%s.bits[i] >> lane) & 1) << (i %% 64);", signame.c_str()));
+			} else {
+				funct_declarations.push_back("  uint64_t value = 0;");
+				funct_declarations.push_back(stringf("  for (int i = 0; i < %d; i++)", w->width));
+				funct_declarations.push_back(stringf("    value |= ((%s.bits[i] >> lane) & 1) << i;", signame.c_str()));
+				funct_declarations.push_back("  return value;");
+			}
+			funct_declarations.push_back("}");
+		}
+	}
+
 	void run(Module *mod)
 	{
 		create_module_struct(mod);
@@ -721,6 +844,9 @@ struct SimplecWorker
 		make_init_func(&work);
 		make_eval_func(&work);
 		make_tick_func(&work);
+
+		if (bitparallel)
+			make_lane_funcs(&work);
 	}
 
 	void write(std::ostream &f)
@@ -760,6 +886,14 @@ struct SimplecBackend : public Backend {
 		log("    -i8, -i16, -i32, -i64\n");
 		log("        set the maximum integer bit width to use in the generated code.\n");
 		log("\n");
+		log("    -bitparallel\n");
+		log("        generate code that simulates 64 independent instances of the design\n");
+		log("        with each call. Every signal bit is stored as a uint64_t word, with\n");
+		log("        one bit per instance, and all gates are evaluated with bitwise\n");
+		log("        operations. Types and functions get an '_x64' suffix, and accessor\n");
+		log("        functions <module>_x64_set_<port>() and <module>_x64_get_<port>()\n");
+		log("        are generated for packing and unpacking the values of one instance.\n");
+		log("\n");
 		log("THIS COMMAND IS UNDER CONSTRUCTION\n");
 		log("\n");
 	}
@@ -795,6 +929,10 @@ struct SimplecBackend : public Backend {
 				worker.max_uintsize = 64;
 				continue;
 			}
+			if (args[argidx] == "-bitparallel") {
+				worker.bitparallel = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
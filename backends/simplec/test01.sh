@@ -0,0 +1,5 @@
+#!/bin/bash
+set -ex
+../../yosys -p 'synth -top test; write_simplec -verbose -i32 test01_uut.c; write_simplec -bitparallel test01_uut_x64.c' test01_uut.v
+clang -o test01_tb test01_tb.c
+./test01_tb
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <assert.h>
+#include "test01_uut.c"
+#include "test01_uut_x64.c"
+
+uint32_t xorshift32()
+{
+	static uint32_t x32 = 314159265;
+	x32 ^= x32 << 13;
+	x32 ^= x32 >> 17;
+	x32 ^= x32 << 5;
+	return x32;
+}
+
+int main()
+{
+	struct test_state_t state;
+	struct test_x64_state_t state_x64;
+	uint32_t a[64], b[64], c[64], s[64];
+
+	for (int i = 0; i < 10; i++)
+	{
+		for (int lane = 0; lane < 64; lane++) {
+			a[lane] = xorshift32();
+			b[lane] = xorshift32();
+			c[lane] = xorshift32();
+			s[lane] = xorshift32() & 15;
+			test_x64_set_a(&state_x64, lane, a[lane]);
+			test_x64_set_b(&state_x64, lane, b[lane]);
+			test_x64_set_c(&state_x64, lane, c[lane]);
+			test_x64_set_s(&state_x64, lane, s[lane]);
+		}
+
+		if (i == 0)
+			test_x64_init(&state_x64);
+		else
+			test_x64_eval(&state_x64);
+
+		for (int lane = 0; lane < 64; lane++) {
+			state.a.value_31_0 = a[lane];
+			state.b.value_31_0 = b[lane];
+			state.c.value_31_0 = c[lane];
+			state.s.value_3_0 = s[lane];
+
+			if (i == 0 && lane == 0)
+				test_init(&state);
+			else
+				test_eval(&state);
+
+			printf("%d/%2d: X=0x%08x Y=0x%08x Z=0x%08x W=0x%x\n", i, lane,
+					(uint32_t)state.x.value_31_0, (uint32_t)state.y.value_31_0,
+					(uint32_t)state.z.value_31_0, (uint32_t)state.w.value_3_0);
+
+			assert(state.x.value_31_0 == ((a[lane] & b[lane]) | c[lane]));
+			assert(state.z.value_31_0 == (a[lane] ^ b[lane] ^ c[lane]));
+
+			assert(test_x64_get_x(&state_x64, lane) == state.x.value_31_0);
+			assert(test_x64_get_y(&state_x64, lane) == state.y.value_31_0);
+			assert(test_x64_get_z(&state_x64, lane) == state.z.value_31_0);
+			assert(test_x64_get_w(&state_x64, lane) == state.w.value_3_0);
+		}
+	}
+
+	return 0;
+}
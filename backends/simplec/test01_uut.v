@@ -0,0 +1,14 @@
+module test(input [31:0] a, b, c, input [3:0] s, output [31:0] x, y, z, output [3:0] w);
+  unit_x unit_x_inst (.a(a), .b(b), .c(c), .x(x));
+  unit_y unit_y_inst (.a(a), .b(b), .s(s[0]), .y(y));
+  assign z = a ^ b ^ c;
+  assign w = s[1] ? a[3:0] : s[2] ? ~b[7:4] : c[31:28] ^ s;
+endmodule
+
+module unit_x(input [31:0] a, b, c, output [31:0] x);
+  assign x = (a & b) | c;
+endmodule
+
+module unit_y(input [31:0] a, b, input s, output [31:0] y);
+  assign y = s ? a | ~b : a & b;
+endmodule
@@ -47,8 +47,23 @@ struct Smt2Worker
 	std::map<RTLIL::SigBit, std::pair<int, int>> fcache;
 	std::map<Cell*, int> memarrays;
 	std::map<int, int> bvsizes;
+	dict<SigSpec, int> bvexprs;
+	dict<SigSpec, std::string> bvexprs_pending;
 	dict<IdString, char*> ids;
 
+	// same as stringf("(|%s#%d| %s)", get_id(module), id, state_name)
+	std::string get_ref(int id, const char *state_name)
+	{
+		std::string str = "(|";
+		str += get_id(module);
+		str.push_back('#');
+		append_decimal(str, id);
+		str += "| ";
+		str += state_name;
+		str.push_back(')');
+		return str;
+	}
+
 	const char *get_id(IdString n)
 	{
 		if (ids.count(n) == 0) {
@@ -280,7 +295,7 @@ struct Smt2Worker
 		auto f = fcache.at(bit);
 		if (f.second >= 0)
 			return stringf("(= ((_ extract %d %d) (|%s#%d| %s)) #b1)", f.second, f.second, get_id(module), f.first, state_name);
-		return stringf("(|%s#%d| %s)", get_id(module), f.first, state_name);
+		return get_ref(f.first, state_name);
 	}
 
 	std::string get_bool(RTLIL::SigSpec sig, const char *state_name = "state")
@@ -304,6 +319,10 @@ struct Smt2Worker
 			sigmap.apply(sig);
 		}
 
+		auto it = bvexprs.find(sig);
+		if (it != bvexprs.end())
+			return get_ref(it->second, state_name);
+
 		for (int i = 0, j = 1; i < GetSize(sig); i += j, j = 1)
 		{
 			if (sig[i].wire == nullptr) {
@@ -332,7 +351,7 @@ struct Smt2Worker
 					j++;
 				}
 				if (t1.second == 0 && j == bvsizes.at(t1.first))
-					subexpr.push_back(stringf("(|%s#%d| %s)", get_id(module), t1.first, state_name));
+					subexpr.push_back(get_ref(t1.first, state_name));
 				else
 					subexpr.push_back(stringf("((_ extract %d %d) (|%s#%d| %s))",
 							t1.second + j - 1, t1.second, get_id(module), t1.first, state_name));
@@ -348,7 +367,7 @@ struct Smt2Worker
 			for (auto bit : sig.extract(i, j))
 				log_assert(bit_driver.count(bit) == 0);
 			makebits(stringf("%s#%d", get_id(module), idcounter), j, log_signal(sig.extract(i, j)));
-			subexpr.push_back(stringf("(|%s#%d| %s)", get_id(module), idcounter, state_name));
+			subexpr.push_back(get_ref(idcounter, state_name));
 			register_bv(sig.extract(i, j), idcounter++);
 		}
 
@@ -358,7 +377,21 @@ struct Smt2Worker
 				if (i > 0) expr += " (concat", end_str += ")";
 				expr += " " + subexpr[i];
 			}
-			return expr.substr(1) + end_str;
+			expr = expr.substr(1) + end_str;
+			if (strcmp(state_name, "state"))
+				return expr;
+			// Concatenations that are needed more than once are emitted as a
+			// function of the state, and all further users refer to that.
+			auto it = bvexprs_pending.find(sig);
+			if (it == bvexprs_pending.end()) {
+				bvexprs_pending[sig] = expr;
+				return expr;
+			}
+			decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) (_ BitVec %d) %s)\n",
+					get_id(module), idcounter, get_id(module), GetSize(sig), expr.c_str()));
+			bvexprs_pending.erase(it);
+			bvexprs[sig] = idcounter;
+			return get_ref(idcounter++, state_name);
 		} else {
 			log_assert(GetSize(subexpr) == 1);
 			return subexpr[0];
@@ -1234,47 +1267,59 @@ struct Smt2Worker
 
 	void write(std::ostream &f)
 	{
-		f << stringf("; yosys-smt2-module %s\n", get_id(module));
+		// collect the output in large blocks instead of many small writes
+		std::string buffer;
+		auto emit = [&](const std::string &str) {
+			buffer += str;
+			if (GetSize(buffer) >= (1 << 20)) {
+				f.write(buffer.data(), buffer.size());
+				buffer.clear();
+			}
+		};
+
+		emit(stringf("; yosys-smt2-module %s\n", get_id(module)));
 
 		if (statebv) {
-			f << stringf("(define-sort |%s_s| () (_ BitVec %d))\n", get_id(module), statebv_width);
+			emit(stringf("(define-sort |%s_s| () (_ BitVec %d))\n", get_id(module), statebv_width));
 			mod_stbv_width[module->name] = statebv_width;
 		} else
 		if (statedt) {
-			f << stringf("(declare-datatype |%s_s| ((|%s_mk|\n", get_id(module), get_id(module));
-			for (auto it : dtmembers)
-				f << it;
-			f << stringf(")))\n");
+			emit(stringf("(declare-datatype |%s_s| ((|%s_mk|\n", get_id(module), get_id(module)));
+			for (auto &it : dtmembers)
+				emit(it);
+			emit(stringf(")))\n"));
 		} else
-			f << stringf("(declare-sort |%s_s| 0)\n", get_id(module));
+			emit(stringf("(declare-sort |%s_s| 0)\n", get_id(module)));
 
-		for (auto it : decls)
-			f << it;
+		for (auto &it : decls)
+			emit(it);
 
-		f << stringf("(define-fun |%s_h| ((state |%s_s|)) Bool ", get_id(module), get_id(module));
+		emit(stringf("(define-fun |%s_h| ((state |%s_s|)) Bool ", get_id(module), get_id(module)));
 		if (GetSize(hier) > 1) {
-			f << "(and\n";
-			for (auto it : hier)
-				f << it;
-			f << "))\n";
+			emit("(and\n");
+			for (auto &it : hier)
+				emit(it);
+			emit("))\n");
 		} else
 		if (GetSize(hier) == 1)
-			f << "\n" + hier.front() + ")\n";
+			emit("\n" + hier.front() + ")\n");
 		else
-			f << "true)\n";
+			emit("true)\n");
 
-		f << stringf("(define-fun |%s_t| ((state |%s_s|) (next_state |%s_s|)) Bool ", get_id(module), get_id(module), get_id(module));
+		emit(stringf("(define-fun |%s_t| ((state |%s_s|) (next_state |%s_s|)) Bool ", get_id(module), get_id(module), get_id(module)));
 		if (GetSize(trans) > 1) {
-			f << "(and\n";
-			for (auto it : trans)
-				f << it;
-			f << "))";
+			emit("(and\n");
+			for (auto &it : trans)
+				emit(it);
+			emit("))");
 		} else
 		if (GetSize(trans) == 1)
-			f << "\n" + trans.front() + ")";
+			emit("\n" + trans.front() + ")");
 		else
-			f << "true)";
-		f << stringf(" ; end of module %s\n", get_id(module));
+			emit("true)");
+		emit(stringf(" ; end of module %s\n", get_id(module)));
+
+		f.write(buffer.data(), buffer.size());
 	}
 };
 
@@ -142,20 +142,20 @@ struct SmvWorker
 				goto continue_with_resize;
 			}
 
-		for (auto &c : sig.chunks()) {
+		// chunks are concatenated MSB first
+		for (auto it = sig.chunks().rbegin(); it != sig.chunks().rend(); ++it) {
+			const SigChunk &c = *it;
 			count_chunks++;
 			if (!s.empty())
-				s = " :: " + s;
+				s += " :: ";
 			if (c.wire) {
+				s += cid(c.wire->name);
 				if (c.offset != 0 || c.width != c.wire->width)
-					s = stringf("%s[%d:%d]", cid(c.wire->name), c.offset+c.width-1, c.offset) + s;
-				else
-					s = cid(c.wire->name) + s;
+					s += stringf("[%d:%d]", c.offset+c.width-1, c.offset);
 			} else {
-				string v = stringf("0ub%d_", c.width);
+				s += stringf("0ub%d_", c.width);
 				for (int i = c.width-1; i >= 0; i--)
-					v += c.data.at(i) == State::S1 ? '1' : '0';
-				s = v + s;
+					s += c.data.at(i) == State::S1 ? '1' : '0';
 			}
 		}
 
@@ -225,6 +225,10 @@ struct SmvWorker
 
 		for (auto cell : module->cells())
 		{
+			// expressions returned by rvalue() are only referenced while
+			// the definitions of the current cell are formatted
+			strbuf.clear();
+
 			// FIXME: $slice, $concat, $mem
 
 			if (cell->type.in(ID($assert)))
@@ -587,13 +591,11 @@ struct SmvWorker
 
 		for (Wire *wire : partial_assignment_wires)
 		{
-			string expr;
+			vector<string> parts;
+			strbuf.clear();
 
 			for (int i = 0; i < wire->width; i++)
 			{
-				if (!expr.empty())
-					expr = " :: " + expr;
-
 				if (partial_assignment_bits.count(sigmap(SigBit(wire, i))))
 				{
 					int width = 1;
@@ -615,7 +617,7 @@ struct SmvWorker
 						width++, i++;
 					}
 
-					expr = stringf("%s[%d:%d]", bit_a.first, bit_a.second+width-1, bit_a.second) + expr;
+					parts.push_back(stringf("%s[%d:%d]", bit_a.first, bit_a.second+width-1, bit_a.second));
 				}
 				else if (sigmap(SigBit(wire, i)).wire == nullptr)
 				{
@@ -633,7 +635,7 @@ struct SmvWorker
 					for (int k = GetSize(sig)-1; k >= 0; k--)
 						bits += sig[k] == State::S1 ? '1' : '0';
 
-					expr = stringf("0ub%d_%s", GetSize(bits), bits.c_str()) + expr;
+					parts.push_back(stringf("0ub%d_%s", GetSize(bits), bits.c_str()));
 				}
 				else if (sigmap(SigBit(wire, i)) == SigBit(wire, i))
 				{
@@ -647,7 +649,7 @@ struct SmvWorker
 						i++, length++;
 					}
 
-					expr = stringf("0ub%d_0", length) + expr;
+					parts.push_back(stringf("0ub%d_0", length));
 				}
 				else
 				{
@@ -662,40 +664,47 @@ struct SmvWorker
 						i++;
 					}
 
-					expr = rvalue(sig) + expr;
+					parts.push_back(rvalue(sig));
 				}
 			}
 
+			string expr;
+			for (auto it = parts.rbegin(); it != parts.rend(); ++it) {
+				if (!expr.empty())
+					expr += " :: ";
+				expr += *it;
+			}
+
 			definitions.push_back(stringf("%s := %s;", cid(wire->name), expr.c_str()));
 		}
 
 		if (!inputvars.empty()) {
 			f << stringf("  IVAR\n");
 			for (const string &line : inputvars)
-				f << stringf("    %s\n", line.c_str());
+				f << "    " << line << "\n";
 		}
 
 		if (!vars.empty()) {
 			f << stringf("  VAR\n");
 			for (const string &line : vars)
-				f << stringf("    %s\n", line.c_str());
+				f << "    " << line << "\n";
 		}
 
 		if (!definitions.empty()) {
 			f << stringf("  DEFINE\n");
 			for (const string &line : definitions)
-				f << stringf("    %s\n", line.c_str());
+				f << "    " << line << "\n";
 		}
 
 		if (!assignments.empty()) {
 			f << stringf("  ASSIGN\n");
 			for (const string &line : assignments)
-				f << stringf("    %s\n", line.c_str());
+				f << "    " << line << "\n";
 		}
 
 		if (!invarspecs.empty()) {
 			for (const string &line : invarspecs)
-				f << stringf("  INVARSPEC %s\n", line.c_str());
+				f << "  INVARSPEC " << line << "\n";
 		}
 	}
 };
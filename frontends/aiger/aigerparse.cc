@@ -325,19 +325,35 @@ static uint32_t parse_xaiger_literal(std::istream &f)
 	return from_big_endian(l);
 }
 
+void AigerReader::reserve_from_header()
+{
+	// Every variable gets a wire, most of them an $_AND_ driver, and
+	// inputs, latches and outputs each get one named port wire on top.
+	// The header is not trusted: counts beyond reserve_limit are left to
+	// the growth path in createWireIfNotExists() and to the containers.
+	const size_t reserve_limit = 1 << 20;
+	auto clamp = [reserve_limit](size_t count) { return std::min(count, reserve_limit); };
+	literal_wires.resize(2*(clamp(M)+1));
+	module->wires_.reserve(module->wires_.size() + clamp((size_t)M+1 + I+L+O));
+	module->cells_.reserve(module->cells_.size() + clamp((size_t)A+L));
+}
+
 RTLIL::Wire* AigerReader::createWireIfNotExists(RTLIL::Module *module, unsigned literal)
 {
 	const unsigned variable = literal >> 1;
 	const bool invert = literal & 1;
-	RTLIL::IdString wire_name(stringf("$aiger%d$%d%s", aiger_autoidx, variable, invert ? "b" : ""));
-	RTLIL::Wire *wire = module->wire(wire_name);
+	if ((literal|1) >= literal_wires.size())
+		literal_wires.resize((literal|1) + 1);
+	RTLIL::Wire *wire = literal_wires[literal];
 	if (wire) return wire;
+	RTLIL::IdString wire_name(stringf("$aiger%d$%d%s", aiger_autoidx, variable, invert ? "b" : ""));
 	log_debug2("Creating %s\n", wire_name.c_str());
 	wire = module->addWire(wire_name);
 	wire->port_input = wire->port_output = false;
+	literal_wires[literal] = wire;
 	if (!invert) return wire;
 	RTLIL::IdString wire_inv_name(stringf("$aiger%d$%d", aiger_autoidx, variable));
-	RTLIL::Wire *wire_inv = module->wire(wire_inv_name);
+	RTLIL::Wire *wire_inv = literal_wires[literal^1];
 	if (wire_inv) {
 		if (module->cell(wire_inv_name)) return wire;
 	}
@@ -345,6 +361,7 @@ RTLIL::Wire* AigerReader::createWireIfNotExists(RTLIL::Module *module, unsigned
 		log_debug2("Creating %s\n", wire_inv_name.c_str());
 		wire_inv = module->addWire(wire_inv_name);
 		wire_inv->port_input = wire_inv->port_output = false;
+		literal_wires[literal^1] = wire_inv;
 	}
 
 	log_debug2("Creating %s = ~%s\n", wire_name.c_str(), wire_inv_name.c_str());
@@ -514,6 +531,8 @@ void AigerReader::parse_aiger_ascii()
 
 	unsigned l1, l2, l3;
 
+	reserve_from_header();
+
 	// Parse inputs
 	int digits = ceil(log10(I));
 	for (unsigned i = 1; i <= I; ++i, ++line_count) {
@@ -628,12 +647,18 @@ void AigerReader::parse_aiger_ascii()
 	std::getline(f, line); // Ignore up to start of next line
 }
 
-static unsigned parse_next_delta_literal(std::istream &f, unsigned ref)
+static unsigned parse_next_delta_literal(std::streambuf *buf, unsigned ref)
 {
 	unsigned x = 0, i = 0;
-	unsigned char ch;
-	while ((ch = f.get()) & 0x80)
+	int ch;
+	while (1) {
+		ch = buf->sbumpc();
+		if (ch == std::char_traits<char>::eof())
+			log_error("Unexpected EOF in AND gate section!\n");
+		if (!(ch & 0x80))
+			break;
 		x |= (ch & 0x7f) << (7 * i++);
+	}
 	return ref - (x | (ch << (7 * i)));
 }
 
@@ -642,6 +667,8 @@ void AigerReader::parse_aiger_binary()
 	unsigned l1, l2, l3;
 	std::string line;
 
+	reserve_from_header();
+
 	// Parse inputs
 	int digits = ceil(log10(I));
 	for (unsigned i = 1; i <= I; ++i) {
@@ -739,10 +766,11 @@ void AigerReader::parse_aiger_binary()
 		std::getline(f, line); // Ignore up to start of next line
 
 	// Parse AND
+	std::streambuf *buf = f.rdbuf();
 	l1 = (I+L+1) << 1;
 	for (unsigned i = 0; i < A; ++i, ++line_count, l1 += 2) {
-		l2 = parse_next_delta_literal(f, l1);
-		l3 = parse_next_delta_literal(f, l2);
+		l2 = parse_next_delta_literal(buf, l1);
+		l3 = parse_next_delta_literal(buf, l2);
 
 		log_debug2("%d %d %d is an AND\n", l1, l2, l3);
 		log_assert(!(l1 & 1));
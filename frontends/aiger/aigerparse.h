@@ -46,6 +46,7 @@ struct AigerReader
     std::vector<RTLIL::Wire*> bad_properties;
     std::vector<RTLIL::Cell*> boxes;
     std::vector<int> mergeability, initial_state;
+    std::vector<RTLIL::Wire*> literal_wires;
 
     AigerReader(RTLIL::Design *design, std::istream &f, RTLIL::IdString module_name, RTLIL::IdString clk_name, std::string map_filename, bool wideports);
     void parse_aiger();
@@ -53,6 +54,7 @@ struct AigerReader
     void parse_aiger_ascii();
     void parse_aiger_binary();
     void post_process();
+    void reserve_from_header();
 
     RTLIL::Wire* createWireIfNotExists(RTLIL::Module *module, unsigned literal);
 };
@@ -29,6 +29,7 @@
 
 #include "kernel/yosys.h"
 #include "libs/sha1/sha1.h"
+#include "backends/ilang/ilang_backend.h"
 #include "ast.h"
 
 YOSYS_NAMESPACE_BEGIN
@@ -1162,9 +1163,281 @@ static AstModule* process_module(AstNode *ast, bool defer, AstNode *original_ast
 	return current_module;
 }
 
+// feed everything that can influence elaboration of an AST subtree into a hasher
+// (source locations are left out, so that moving a module within its file
+// does not count as a change)
+static void hash_ast_node(SHA1 &hasher, const AstNode *node)
+{
+	std::string data = stringf("%d|%s|%d%d%d%d%d%d%d%d%d%d%d%d|%d|%d|%d|%u|%.17g|", int(node->type), node->str.c_str(),
+			node->is_input, node->is_output, node->is_reg, node->is_logic, node->is_signed, node->is_string,
+			node->is_wand, node->is_wor, node->range_valid, node->range_swapped, node->is_unsized, node->is_custom_type,
+			node->port_id, node->range_left, node->range_right, node->integer, node->realvalue);
+	for (auto bit : node->bits)
+		data += char('0' + int(bit));
+	for (auto dim : node->multirange_dimensions)
+		data += stringf(",%d", dim);
+	data += stringf("|%d|%d\n", GetSize(node->attributes), GetSize(node->children));
+	hasher.update(data);
+
+	for (auto &attr : node->attributes) {
+		hasher.update(attr.first.str() + "\n");
+		hash_ast_node(hasher, attr.second);
+	}
+	for (auto child : node->children)
+		hash_ast_node(hasher, child);
+}
+
+// dump attributes, parameters or connections to a hasher stream in sorted order (leaving out 'module_not_derived',
+// which the hierarchy pass removes from all cells)
+static void dump_sorted_consts(std::ostream &f, const char *keyword, const dict<RTLIL::IdString, RTLIL::Const> &consts)
+{
+	std::map<std::string, const RTLIL::Const*> sorted;
+	for (auto &it : consts)
+		if (it.first != ID::module_not_derived)
+			sorted[it.first.str()] = &it.second;
+	for (auto &it : sorted) {
+		f << keyword << " " << it.first << " " << it.second->flags << " ";
+		ILANG_BACKEND::dump_const(f, *it.second);
+		f << "\n";
+	}
+}
+
+template<typename T>
+static std::map<std::string, T*> sorted_by_name(const dict<RTLIL::IdString, T*> &objects)
+{
+	std::map<std::string, T*> sorted;
+	for (auto &it : objects)
+		sorted[it.first.str()] = it.second;
+	return sorted;
+}
+
+// collect the names of all nodes in an AST subtree
+static void collect_ast_names(const AstNode *node, pool<std::string> &names)
+{
+	if (!node->str.empty())
+		names.insert(node->str);
+	for (auto &attr : node->attributes)
+		collect_ast_names(attr.second, names);
+	for (auto child : node->children)
+		collect_ast_names(child, names);
+}
+
+// hash the global and package declarations a module refers to, directly or through other declarations (every read
+// appends to design->verilog_globals and design->verilog_packages, so only the latest declaration of a name counts)
+static void hash_used_globals(SHA1 &hasher, const AstNode *module, RTLIL::Design *design)
+{
+	dict<std::string, const AstNode*> declarations;
+	auto declare = [&](const std::string &name, const AstNode *node) {
+		if (!name.empty())
+			declarations[name] = node;
+	};
+	for (auto n : design->verilog_globals) {
+		declare(n->str, n);
+		if (n->type == AST_ENUM)
+			for (auto e : n->children)
+				declare(e->str, n);
+	}
+	for (auto n : design->verilog_packages)
+		for (auto o : n->children) {
+			if (o->type == AST_ENUM) {
+				for (auto e : o->children)
+					declare(n->str + std::string("::") + e->str.substr(1), o);
+			} else if (!o->str.empty())
+				declare(n->str + std::string("::") + o->str.substr(1), o);
+		}
+
+	pool<std::string> names;
+	collect_ast_names(module, names);
+	std::map<std::string, const AstNode*> used;
+	std::vector<std::string> queue(names.begin(), names.end());
+	while (!queue.empty()) {
+		std::string name = queue.back();
+		queue.pop_back();
+		auto it = declarations.find(name);
+		if (it == declarations.end() || used.count(name))
+			continue;
+		used[name] = it->second;
+		pool<std::string> decl_names;
+		collect_ast_names(it->second, decl_names);
+		for (auto &decl_name : decl_names)
+			if (names.insert(decl_name).second)
+				queue.push_back(decl_name);
+	}
+
+	for (auto &it : used) {
+		hasher.update(it.first + "\n");
+		hash_ast_node(hasher, it.second);
+	}
+}
+
+// hash the contents of a module (but not its own attributes), to tell whether other passes changed it since
+// it was elaborated (every container is hashed in sorted order, so that RTLIL::Design::sort(), which write_ilang
+// and many passes call, does not count as a change)
+static std::string hash_module_contents(RTLIL::Module *module)
+{
+	std::stringstream f;
+	for (auto &it : sorted_by_name(module->wires_)) {
+		RTLIL::Wire *wire = it.second;
+		dump_sorted_consts(f, "attribute", wire->attributes);
+		f << "wire " << wire->name.str() << " " << wire->width << " " << wire->start_offset << " " << wire->upto << " "
+				<< wire->port_id << " " << wire->port_input << wire->port_output << " " << wire->is_signed << "\n";
+	}
+	for (auto &it : sorted_by_name(module->memories)) {
+		RTLIL::Memory *memory = it.second;
+		dump_sorted_consts(f, "attribute", memory->attributes);
+		f << "memory " << memory->name.str() << " " << memory->width << " " << memory->start_offset << " "
+				<< memory->size << "\n";
+	}
+	for (auto &it : sorted_by_name(module->cells_)) {
+		RTLIL::Cell *cell = it.second;
+		dump_sorted_consts(f, "attribute", cell->attributes);
+		f << "cell " << cell->type.str() << " " << cell->name.str() << "\n";
+		dump_sorted_consts(f, "parameter", cell->parameters);
+		std::map<std::string, const RTLIL::SigSpec*> connections;
+		for (auto &conn : cell->connections())
+			connections[conn.first.str()] = &conn.second;
+		for (auto &conn : connections) {
+			f << "connect " << conn.first << " ";
+			ILANG_BACKEND::dump_sigspec(f, *conn.second);
+			f << "\n";
+		}
+	}
+	for (auto &it : sorted_by_name(module->processes))
+		ILANG_BACKEND::dump_proc(f, "", it.second);
+	std::vector<std::string> connections;
+	for (auto &it : module->connections()) {
+		std::stringstream conn;
+		ILANG_BACKEND::dump_conn(conn, "", it.first, it.second);
+		connections.push_back(conn.str());
+	}
+	std::sort(connections.begin(), connections.end());
+	for (auto &conn : connections)
+		f << conn;
+	return sha1(f.str());
+}
+
+// record the source hash of a module elaborated by an incremental read, and the hash of its contents
+static void set_incremental_hashes(RTLIL::Module *module, const std::string &ast_hash)
+{
+	module->set_string_attribute(ID(ast_hash), ast_hash);
+	module->set_string_attribute(ID(ast_contents_hash), hash_module_contents(module));
+}
+
+// check whether a module was derived from the module 'base' by AstModule::derive()
+static bool is_derived_module(const std::string &name, const std::string &base)
+{
+	std::string stripped_base = base;
+	if (stripped_base.compare(0, 9, "$abstract") == 0) {
+		stripped_base = stripped_base.substr(9);
+		if (name == stripped_base)
+			return true;
+	}
+
+	// derived modules are named $paramod$<sha1>\base or $paramod\base\<parameters>, optionally followed by
+	// $interfaces$<interfaces>, which is also appended to the names of modules derived without parameters
+	std::string rest = name;
+	bool has_parameters = false;
+	if (name.compare(0, 9, "$paramod$") == 0)
+		rest = name.substr(std::min(name.size(), size_t(9 + 40)));
+	else if (name.compare(0, 8, "$paramod") == 0)
+		rest = name.substr(8), has_parameters = true;
+	if (rest.compare(0, stripped_base.size(), stripped_base) != 0)
+		return false;
+	rest = rest.substr(stripped_base.size());
+	if (rest.compare(0, 12, "$interfaces$") == 0)
+		return true;
+	if (has_parameters)
+		return rest.empty() || rest[0] == '\\';
+	return rest.empty() && name != stripped_base;
+}
+
+// check whether a module was created by AstModule::derive(), and can be derived again by the hierarchy pass
+static bool is_any_derived_module(RTLIL::Design *design, const std::string &name)
+{
+	return name.compare(0, 8, "$paramod") == 0 || name.find("$interfaces$") != std::string::npos ||
+			design->module("$abstract" + name) != nullptr;
+}
+
+// after an incremental read, remove the modules derived from a module whose source changed and elaborate again
+// every module that instantiates one, directly or through other modules, so that no module keeps the state of
+// a previous version of another module
+static void invalidate_instantiators(RTLIL::Design *design, pool<std::string> invalid, const dict<std::string, std::string> &read_modules,
+		const dict<std::string, std::pair<AstNode*, std::string>> &kept_modules, bool defer)
+{
+	std::vector<RTLIL::Module*> invalidated;
+	for (bool did_something = true; did_something;) {
+		did_something = false;
+		for (auto mod : design->modules()) {
+			std::string name = mod->name.str();
+			if (invalid.count(name))
+				continue;
+			// modules that were just elaborated are up to date
+			if (read_modules.count(name) && !kept_modules.count(name))
+				continue;
+			bool is_invalid = false;
+			for (auto cell : mod->cells())
+				if (invalid.count(cell->type.str())) {
+					is_invalid = true;
+					break;
+				}
+			if (!is_invalid && is_any_derived_module(design, name))
+				for (auto &base : invalid)
+					if (is_derived_module(name, base)) {
+						is_invalid = true;
+						break;
+					}
+			if (is_invalid) {
+				invalid.insert(name);
+				invalidated.push_back(mod);
+				did_something = true;
+			}
+		}
+	}
+
+	// modules kept by this read are elaborated again from the AST that was just read
+	std::vector<AstModule*> rederive;
+	for (auto mod : invalidated) {
+		std::string name = mod->name.str();
+		if (kept_modules.count(name)) {
+			log("Elaborating kept module `%s' again, as it instantiates a replaced module.\n", name.c_str());
+			design->remove(mod);
+			RTLIL::Module *module = process_module(kept_modules.at(name).first, defer);
+			set_incremental_hashes(module, kept_modules.at(name).second);
+			design->add(module);
+			current_ast_mod = nullptr;
+			continue;
+		}
+		AstModule *ast_mod = dynamic_cast<AstModule*>(mod);
+		if (is_any_derived_module(design, name)) {
+			log("Removing derived module `%s' of a replaced module.\n", name.c_str());
+			design->remove(mod);
+		} else if (ast_mod != nullptr && ast_mod->ast != nullptr) {
+			rederive.push_back(ast_mod);
+		} else {
+			log_warning("Module `%s' instantiates a replaced module, but cannot be elaborated again.\n", name.c_str());
+		}
+	}
+
+	// other modules are elaborated again from the AST they were elaborated from, with the options they were read with
+	for (auto ast_mod : rederive) {
+		log("Elaborating module `%s' again, as it instantiates a replaced module.\n", ast_mod->name.c_str());
+		AstNode *ast = ast_mod->ast->clone();
+		std::string ast_hash = ast_mod->get_string_attribute(ID(ast_hash));
+		ast_mod->loadconfig();
+		design->remove(ast_mod);
+		RTLIL::Module *module = process_module(ast, false);
+		if (!ast_hash.empty())
+			set_incremental_hashes(module, ast_hash);
+		design->add(module);
+		current_ast_mod = nullptr;
+		delete ast;
+	}
+}
+
 // create AstModule instances for all modules in the AST tree and add them to 'design'
 void AST::process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump_ast2, bool no_dump_ptr, bool dump_vlog1, bool dump_vlog2, bool dump_rtlil,
-		bool nolatches, bool nomeminit, bool nomem2reg, bool mem2reg, bool noblackbox, bool lib, bool nowb, bool noopt, bool icells, bool pwires, bool nooverwrite, bool overwrite, bool defer, bool autowire)
+		bool nolatches, bool nomeminit, bool nomem2reg, bool mem2reg, bool noblackbox, bool lib, bool nowb, bool noopt, bool icells, bool pwires, bool nooverwrite, bool overwrite, bool defer, bool autowire,
+		bool incremental, bool keepmodified)
 {
 	current_ast = ast;
 	current_ast_mod = nullptr;
@@ -1186,11 +1459,36 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump
 	flag_pwires = pwires;
 	flag_autowire = autowire;
 
+	// for incremental reads: the source hashes of the modules read, the modules kept (with their AST and source
+	// hash), and the modules replaced by a different version
+	dict<std::string, std::string> read_modules;
+	dict<std::string, std::pair<AstNode*, std::string>> kept_modules;
+	pool<std::string> replaced_modules;
+
 	log_assert(current_ast->type == AST_DESIGN);
 	for (auto it = current_ast->children.begin(); it != current_ast->children.end(); it++)
 	{
 		if ((*it)->type == AST_MODULE || (*it)->type == AST_INTERFACE)
 		{
+			if (flag_icells && (*it)->str.compare(0, 2, "\\$") == 0)
+				(*it)->str = (*it)->str.substr(1);
+
+			if (defer)
+				(*it)->str = "$abstract" + (*it)->str;
+
+			// the module is hashed before the global and package declarations are appended to it, which grow with
+			// every read; the declarations it uses are hashed separately
+			std::string ast_hash;
+			if (incremental) {
+				SHA1 hasher;
+				hasher.update(stringf("%d%d%d%d%d%d%d%d%d%d%d%d\n", nolatches, nomeminit, nomem2reg, mem2reg, noblackbox,
+						lib, nowb, noopt, icells, pwires, defer, autowire));
+				hash_ast_node(hasher, *it);
+				hash_used_globals(hasher, *it, design);
+				ast_hash = hasher.final();
+				read_modules[(*it)->str] = ast_hash;
+			}
+
 			for (auto n : design->verilog_globals)
 				(*it)->children.push_back(n->clone());
 
@@ -1211,15 +1509,17 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump
 				}
 			}
 
-			if (flag_icells && (*it)->str.compare(0, 2, "\\$") == 0)
-				(*it)->str = (*it)->str.substr(1);
-
-			if (defer)
-				(*it)->str = "$abstract" + (*it)->str;
-
 			if (design->has((*it)->str)) {
 				RTLIL::Module *existing_mod = design->module((*it)->str);
-				if (!nooverwrite && !overwrite && !existing_mod->get_blackbox_attribute()) {
+				if (incremental && existing_mod->get_string_attribute(ID(ast_hash)) == ast_hash) {
+					if (keepmodified || existing_mod->get_string_attribute(ID(ast_contents_hash)) == hash_module_contents(existing_mod)) {
+						log("Keeping unchanged module `%s'.\n", (*it)->str.c_str());
+						kept_modules[(*it)->str] = std::make_pair(*it, ast_hash);
+						continue;
+					}
+					log("Module `%s' was changed since it was read, elaborating it again.\n", (*it)->str.c_str());
+				}
+				if (!nooverwrite && !overwrite && !incremental && !existing_mod->get_blackbox_attribute()) {
 					log_file_error((*it)->filename, (*it)->location.first_line, "Re-definition of module `%s'!\n", (*it)->str.c_str());
 				} else if (nooverwrite) {
 					log("Ignoring re-definition of module `%s' at %s:%d.%d-%d.%d.\n",
@@ -1229,11 +1529,16 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump
 					log("Replacing existing%s module `%s' at %s:%d.%d-%d.%d.\n",
 							existing_mod->get_bool_attribute(ID::blackbox) ? " blackbox" : "",
 							(*it)->str.c_str(), (*it)->filename.c_str(), (*it)->location.first_line, (*it)->location.first_column, (*it)->location.last_line, (*it)->location.last_column);
+					if (incremental && existing_mod->get_string_attribute(ID(ast_hash)) != ast_hash)
+						replaced_modules.insert((*it)->str);
 					design->remove(existing_mod);
 				}
 			}
 
-			design->add(process_module(*it, defer));
+			RTLIL::Module *module = process_module(*it, defer);
+			if (incremental)
+				set_incremental_hashes(module, ast_hash);
+			design->add(module);
 			current_ast_mod = nullptr;
 		}
 		else if ((*it)->type == AST_PACKAGE) {
@@ -1249,6 +1554,33 @@ void AST::process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump
 			current_scope.clear();
 		}
 	}
+
+	if (incremental)
+	{
+		// modules derived from the modules read are only kept if they were derived from the same source, and
+		// (unless requested otherwise) were not changed since
+		std::vector<RTLIL::Module*> stale_derived;
+		for (auto mod : design->modules()) {
+			std::string name = mod->name.str();
+			if (!is_any_derived_module(design, name))
+				continue;
+			for (auto &it : read_modules)
+				if (is_derived_module(name, it.first)) {
+					if (mod->get_string_attribute(ID(ast_hash)) != it.second ||
+							(!keepmodified && mod->get_string_attribute(ID(ast_contents_hash)) != hash_module_contents(mod)))
+						stale_derived.push_back(mod);
+					break;
+				}
+		}
+		for (auto mod : stale_derived) {
+			log("Removing outdated derived module `%s'.\n", log_id(mod));
+			replaced_modules.insert(mod->name.str());
+			design->remove(mod);
+		}
+
+		if (!replaced_modules.empty())
+			invalidate_instantiators(design, replaced_modules, read_modules, kept_modules, defer);
+	}
 }
 
 // AstModule destructor
@@ -1503,6 +1835,9 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, const dict<RTLIL::IdStr
 			mod->set_bool_attribute(ID::interfaces_replaced_in_module);
 		}
 
+		if (has_attribute(ID(ast_hash)))
+			set_incremental_hashes(mod, get_string_attribute(ID(ast_hash)));
+
 	} else {
 		log("Found cached RTLIL representation for module `%s'.\n", modname.c_str());
 	}
@@ -1523,6 +1858,8 @@ RTLIL::IdString AstModule::derive(RTLIL::Design *design, const dict<RTLIL::IdStr
 		new_ast->str = modname;
 		design->add(process_module(new_ast, false, NULL, quiet));
 		design->module(modname)->check();
+		if (has_attribute(ID(ast_hash)))
+			set_incremental_hashes(design->module(modname), get_string_attribute(ID(ast_hash)));
 	} else if (!quiet) {
 		log("Found cached RTLIL representation for module `%s'.\n", modname.c_str());
 	}
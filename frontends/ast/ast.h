@@ -192,12 +192,20 @@ namespace AST
 		// node content - most of it is unused in most node types
 		std::string str;
 		std::vector<RTLIL::State> bits;
-		bool is_input, is_output, is_reg, is_logic, is_signed, is_string, is_wand, is_wor, range_valid, range_swapped, was_checked, is_unsized, is_custom_type;
+		bool is_input : 1, is_output : 1, is_reg : 1, is_logic : 1, is_signed : 1, is_string : 1, is_wand : 1, is_wor : 1,
+				range_valid : 1, range_swapped : 1, was_checked : 1, is_unsized : 1, is_custom_type : 1;
+		// set for IDs typed to an enumeration, not used
+		bool is_enum : 1;
+
+		// this is used by simplify to detect if basic analysis has been performed already on the node
+		bool basic_prep : 1;
+
+		// this is used for ID references in RHS expressions that should use the "new" value for non-blocking assignments
+		bool lookahead : 1;
+
 		int port_id, range_left, range_right;
 		uint32_t integer;
 		double realvalue;
-		// set for IDs typed to an enumeration, not used
-		bool is_enum;
 
 		// if this is a multirange memory then this vector contains offset and length of each dimension
 		std::vector<int> multirange_dimensions;
@@ -205,12 +213,6 @@ namespace AST
 		// this is set by simplify and used during RTLIL generation
 		AstNode *id2ast;
 
-		// this is used by simplify to detect if basic analysis has been performed already on the node
-		bool basic_prep;
-
-		// this is used for ID references in RHS expressions that should use the "new" value for non-blocking assignments
-		bool lookahead;
-
 		// this is the original sourcecode location that resulted in this AST node
 		// it is automatically set by the constructor using AST::current_filename and
 		// the AST::get_line_num() callback function.
@@ -315,7 +317,8 @@ namespace AST
 
 	// process an AST tree (ast must point to an AST_DESIGN node) and generate RTLIL code
 	void process(RTLIL::Design *design, AstNode *ast, bool dump_ast1, bool dump_ast2, bool no_dump_ptr, bool dump_vlog1, bool dump_vlog2, bool dump_rtlil, bool nolatches, bool nomeminit,
-			bool nomem2reg, bool mem2reg, bool noblackbox, bool lib, bool nowb, bool noopt, bool icells, bool pwires, bool nooverwrite, bool overwrite, bool defer, bool autowire);
+			bool nomem2reg, bool mem2reg, bool noblackbox, bool lib, bool nowb, bool noopt, bool icells, bool pwires, bool nooverwrite, bool overwrite, bool defer, bool autowire,
+			bool incremental, bool keepmodified);
 
 	// parametric modules are supported directly by the AST library
 	// therefore we need our own derivate of RTLIL::Module with overloaded virtual functions
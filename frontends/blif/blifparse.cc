@@ -23,7 +23,6 @@ YOSYS_NAMESPACE_BEGIN
 
 static bool read_next_line(char *&buffer, size_t &buffer_size, int &line_count, std::istream &f)
 {
-	string strbuf;
 	int buffer_len = 0;
 	buffer[0] = 0;
 
@@ -43,13 +42,19 @@ static bool read_next_line(char *&buffer, size_t &buffer_size, int &line_count,
 			if (buffer_len > 0 && buffer[buffer_len-1] == '\\')
 				buffer[--buffer_len] = 0;
 			line_count++;
-			if (!std::getline(f, strbuf))
-				return false;
-			while (buffer_size-buffer_len < strbuf.size()+1) {
+			// read the line straight into the buffer, growing it
+			// whenever a line does not fit into the remaining space
+			while (1) {
+				f.getline(buffer+buffer_len, buffer_size-buffer_len);
+				if (!f.fail())
+					break;
+				if (f.eof() || f.bad())
+					return false;
+				f.clear();
+				buffer_len += strlen(buffer + buffer_len);
 				buffer_size *= 2;
 				buffer = (char*)realloc(buffer, buffer_size);
 			}
-			strcpy(buffer+buffer_len, strbuf.c_str());
 		} else
 			return true;
 	}
@@ -526,19 +531,22 @@ void parse_blif(RTLIL::Design *design, std::istream &f, IdString dff_name, bool
 			log_assert(sopcell->parameters[ID::WIDTH].as_int() == input_len);
 			sopcell->parameters[ID::DEPTH] = sopcell->parameters[ID::DEPTH].as_int() + 1;
 
+			vector<State> &table_bits = sopcell->parameters[ID::TABLE].bits;
+			table_bits.reserve(table_bits.size() + 2*input_len);
+
 			for (int i = 0; i < input_len; i++)
 				switch (input[i]) {
 					case '0':
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S1);
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S0);
+						table_bits.push_back(State::S1);
+						table_bits.push_back(State::S0);
 						break;
 					case '1':
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S0);
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S1);
+						table_bits.push_back(State::S0);
+						table_bits.push_back(State::S1);
 						break;
 					default:
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S0);
-						sopcell->parameters[ID::TABLE].bits.push_back(State::S0);
+						table_bits.push_back(State::S0);
+						table_bits.push_back(State::S0);
 						break;
 				}
 
@@ -559,20 +567,25 @@ void parse_blif(RTLIL::Design *design, std::istream &f, IdString dff_name, bool
 			if (input_len > 12)
 				goto error;
 
-			for (int i = 0; i < (1 << input_len); i++) {
-				for (int j = 0; j < input_len; j++) {
-					char c1 = input[j];
-					if (c1 != '-') {
-						char c2 = (i & (1 << j)) != 0 ? '1' : '0';
-						if (c1 != c2)
-							goto try_next_value;
-					}
-				}
-				lutptr->bits.at(i) = !strcmp(output, "0") ? RTLIL::State::S0 : RTLIL::State::S1;
-			try_next_value:;
+			// a cube matches all LUT entries i with (i & care_mask) == care_value
+			int care_mask = 0, care_value = 0;
+			for (int j = 0; j < input_len; j++) {
+				if (input[j] == '-')
+					continue;
+				care_mask |= 1 << j;
+				if (input[j] == '1')
+					care_value |= 1 << j;
+				else if (input[j] != '0')
+					care_value |= 1 << input_len;
 			}
 
-			lut_default_state = !strcmp(output, "0") ? RTLIL::State::S1 : RTLIL::State::S0;
+			RTLIL::State output_state = !strcmp(output, "0") ? RTLIL::State::S0 : RTLIL::State::S1;
+
+			for (int i = 0; i < (1 << input_len); i++)
+				if ((i & care_mask) == care_value)
+					lutptr->bits.at(i) = output_state;
+
+			lut_default_state = output_state == RTLIL::State::S0 ? RTLIL::State::S1 : RTLIL::State::S0;
 		}
 	}
 
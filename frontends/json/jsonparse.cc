@@ -251,7 +251,46 @@ void json_parse_attr_param(dict<IdString, Const> &results, JsonNode *node)
 	}
 }
 
-void json_import(Design *design, string &modname, JsonNode *node)
+// Net numbers in JSON netlists are usually small dense integers, so the SigBit
+// for each net number is kept in a flat vector instead of a dict. Net numbers
+// far beyond the number of nets seen so far go into a dict, so that a netlist
+// with sparse numbering can not make the vector grow without bound.
+struct JsonSignalBits
+{
+	vector<SigBit> bits;
+	dict<int, SigBit> sparse_bits;
+	int num_bits = 0;
+
+	bool dense(int bitidx) const {
+		return bitidx >= 0 && bitidx < std::max(1024, 4 * num_bits);
+	}
+
+	bool count(int bitidx) const {
+		if (bitidx >= 0 && bitidx < GetSize(bits) && bits[bitidx].wire != nullptr)
+			return true;
+		return sparse_bits.count(bitidx) != 0;
+	}
+
+	const SigBit &at(int bitidx) const {
+		log_assert(count(bitidx));
+		if (bitidx >= 0 && bitidx < GetSize(bits) && bits[bitidx].wire != nullptr)
+			return bits[bitidx];
+		return sparse_bits.at(bitidx);
+	}
+
+	SigBit &operator[](int bitidx) {
+		if (!count(bitidx))
+			num_bits++;
+		if (sparse_bits.count(bitidx) || !dense(bitidx))
+			return sparse_bits[bitidx];
+		if (bitidx < GetSize(bits))
+			return bits[bitidx];
+		bits.resize(bitidx + 1);
+		return bits[bitidx];
+	}
+};
+
+void json_import(Design *design, const string &modname, JsonNode *node)
 {
 	log("Importing module %s from JSON tree.\n", modname.c_str());
 
@@ -266,7 +305,7 @@ void json_import(Design *design, string &modname, JsonNode *node)
 	if (node->data_dict.count("attributes"))
 		json_parse_attr_param(module->attributes, node->data_dict.at("attributes"));
 
-	dict<int, SigBit> signal_bits;
+	JsonSignalBits signal_bits;
 
 	if (node->data_dict.count("ports"))
 	{
@@ -533,6 +572,32 @@ void json_import(Design *design, string &modname, JsonNode *node)
 	}
 }
 
+int json_skip_ws(std::istream &f, char extra = 0)
+{
+	while (1)
+	{
+		int ch = f.get();
+
+		if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || (extra != 0 && ch == extra))
+			continue;
+
+		return ch;
+	}
+}
+
+string json_parse_key(std::istream &f)
+{
+	JsonNode key(f);
+
+	if (key.type != 'S')
+		log_error("Unexpected non-string key in JSON dict.\n");
+
+	if (json_skip_ws(f) != ':')
+		log_error("Missing ':' after key '%s' in JSON dict.\n", key.data_string.c_str());
+
+	return key.data_string;
+}
+
 struct JsonFrontend : public Frontend {
 	JsonFrontend() : Frontend("json", "read JSON file") { }
 	void help() YS_OVERRIDE
@@ -544,6 +609,10 @@ struct JsonFrontend : public Frontend {
 		log("Load modules from a JSON file into the current design See \"help write_json\"\n");
 		log("for a description of the file format.\n");
 		log("\n");
+		log("Modules are imported one at a time, in the order in which they appear in the\n");
+		log("file. A module that is defined twice (in the file, or in the file and the\n");
+		log("current design) is an error.\n");
+		log("\n");
 	}
 	void execute(std::istream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
@@ -560,20 +629,54 @@ struct JsonFrontend : public Frontend {
 		}
 		extra_args(f, filename, args, argidx);
 
-		JsonNode root(*f);
+		// Only the tree of a single module is held in memory at a time: the
+		// top-level dictionary and the "modules" dictionary are read key by
+		// key and each module is imported and freed as soon as it is parsed.
 
-		if (root.type != 'D')
+		if (json_skip_ws(*f) != '{')
 			log_error("JSON root node is not a dictionary.\n");
 
-		if (root.data_dict.count("modules") != 0)
+		while (1)
 		{
-			JsonNode *modules = root.data_dict.at("modules");
+			int ch = json_skip_ws(*f, ',');
 
-			if (modules->type != 'D')
+			if (ch == EOF)
+				log_error("Unexpected EOF in JSON file.\n");
+
+			if (ch == '}')
+				break;
+
+			f->unget();
+			string key = json_parse_key(*f);
+
+			if (key != "modules") {
+				JsonNode value(*f);
+				continue;
+			}
+
+			if (json_skip_ws(*f) != '{')
 				log_error("JSON modules node is not a dictionary.\n");
 
-			for (auto &it : modules->data_dict)
-				json_import(design, it.first, it.second);
+			while (1)
+			{
+				ch = json_skip_ws(*f, ',');
+
+				if (ch == EOF)
+					log_error("Unexpected EOF in JSON file.\n");
+
+				if (ch == '}')
+					break;
+
+				f->unget();
+				string modname = json_parse_key(*f);
+
+				JsonNode module_node(*f);
+
+				if (module_node.type != 'D')
+					log_error("JSON module node '%s' is not a dictionary.\n", modname.c_str());
+
+				json_import(design, modname, &module_node);
+			}
 		}
 	}
 } JsonFrontend;
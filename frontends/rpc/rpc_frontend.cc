@@ -115,7 +115,7 @@ struct RpcServer {
 		return modules;
 	}
 
-	std::pair<std::string, std::string> derive_module(const std::string &module, const dict<RTLIL::IdString, RTLIL::Const> &parameters) {
+	std::tuple<std::string, std::string, std::string> derive_module(const std::string &module, const dict<RTLIL::IdString, RTLIL::Const> &parameters) {
 		Json::object json_parameters;
 		for (auto &param : parameters) {
 			std::string type, value;
@@ -141,16 +141,18 @@ struct RpcServer {
 			{ "parameters", json_parameters },
 		});
 		bool is_valid = true;
-		std::string frontend, source;
+		std::string frontend, source, path;
 		if (response["frontend"].is_string())
 			frontend = response["frontend"].string_value();
 		else is_valid = false;
 		if (response["source"].is_string())
 			source = response["source"].string_value();
+		else if (response["path"].is_string())
+			path = response["path"].string_value();
 		else is_valid = false;
 		if (!is_valid)
 			log_cmd_error("RPC frontend returned malformed response: %s\n", response.dump().c_str());
-		return std::make_pair(frontend, source);
+		return std::make_tuple(frontend, source, path);
 	}
 };
 
@@ -182,12 +184,19 @@ struct RpcModule : RTLIL::Module {
 		if (design->has(derived_name)) {
 			log("Found cached RTLIL representation for module `%s'.\n", derived_name.c_str());
 		} else {
-			std::string command, input;
-			std::tie(command, input) = server->derive_module(stripped_name.substr(1), parameters);
+			std::string command, input, path;
+			std::tie(command, input, path) = server->derive_module(stripped_name.substr(1), parameters);
 
-			std::istringstream input_stream(input);
 			RTLIL::Design *derived_design = new RTLIL::Design;
-			Frontend::frontend_call(derived_design, &input_stream, "<rpc>" + derived_name.substr(8), command);
+			if (path.empty()) {
+				std::istringstream input_stream(input);
+				Frontend::frontend_call(derived_design, &input_stream, "<rpc>" + derived_name.substr(8), command);
+			} else {
+				std::ifstream input_stream(path, std::ios::binary);
+				if (input_stream.fail())
+					log_cmd_error("Can't open RPC frontend output `%s': %s\n", path.c_str(), strerror(errno));
+				Frontend::frontend_call(derived_design, &input_stream, path, command);
+			}
 			derived_design->check();
 
 			dict<std::string, std::string> name_mangling;
@@ -379,6 +388,7 @@ struct RpcFrontend : public Pass {
 		log("        \"<param-name>\": {\"type\": \"[unsigned|signed|string|real]\",\n");
 		log("                           \"value\": \"<param-value>\"}, ...}}\n");
 		log("    <- {\"frontend\": \"[ilang|verilog|...]\",\"source\": \"<source>\"}}\n");
+		log("    <- {\"frontend\": \"[ilang|verilog|...]\",\"path\": \"<path>\"}}\n");
 		log("    <- {\"error\": \"<error-message>\"}\n");
 		log("        request for the module <module-name> to be derived for a specific set of\n");
 		log("        parameters. <param-name> starts with \\ for named parameters, and with $\n");
@@ -389,6 +399,13 @@ struct RpcFrontend : public Pass {
 		log("        convenient representation of the module. the derived module is cached,\n");
 		log("        so the response should be the same whenever the same set of parameters\n");
 		log("        is provided.\n");
+		log("        instead of the <source> itself, the frontend may return the <path> of a\n");
+		log("        file containing it (e.g. in a tmpfs such as /dev/shm). the file is read\n");
+		log("        directly by the Yosys <frontend>, which avoids quoting and copying large\n");
+		log("        netlists through the JSON channel and allows binary formats such as\n");
+		log("        binary AIGER. the file is not deleted by Yosys. the 'src' attributes\n");
+		log("        created by the <frontend> then refer to <path> rather than to\n");
+		log("        <rpc><module-name>.\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) YS_OVERRIDE
 	{
@@ -197,6 +197,23 @@ struct VerilogFrontend : public Frontend {
 		log("    -overwrite\n");
 		log("        overwrite existing modules with the same name\n");
 		log("\n");
+		log("    -incremental\n");
+		log("        store a hash of each module's parsed source (after preprocessing)\n");
+		log("        and of the frontend options in the 'ast_hash' module attribute.\n");
+		log("        Existing modules with a matching hash that were not changed by other\n");
+		log("        passes since they were read are kept instead of being elaborated\n");
+		log("        again. All other existing modules with the same name are replaced.\n");
+		log("        Modules derived from a replaced module (e.g. for other parameter\n");
+		log("        values) are removed, and all modules that instantiate a replaced\n");
+		log("        module, directly or through other modules, are elaborated again.\n");
+		log("        The 'src' attributes of kept modules are not updated.\n");
+		log("\n");
+		log("    -keepmodified\n");
+		log("        with -incremental, also keep unchanged modules (and modules derived\n");
+		log("        from them) that were changed by other passes since they were read,\n");
+		log("        e.g. by synthesis. Modules that had a replaced module flattened into\n");
+		log("        them are not detected as instantiating it.\n");
+		log("\n");
 		log("    -defer\n");
 		log("        only read the abstract syntax tree and defer actual compilation\n");
 		log("        to a later 'hierarchy' command. Useful in cases where the default\n");
@@ -253,6 +270,8 @@ struct VerilogFrontend : public Frontend {
 		bool flag_nooverwrite = false;
 		bool flag_overwrite = false;
 		bool flag_defer = false;
+		bool flag_incremental = false;
+		bool flag_keepmodified = false;
 		bool flag_noblackbox = false;
 		bool flag_nowb = false;
 		define_map_t defines_map;
@@ -405,6 +424,14 @@ struct VerilogFrontend : public Frontend {
 				flag_overwrite = true;
 				continue;
 			}
+			if (arg == "-incremental") {
+				flag_incremental = true;
+				continue;
+			}
+			if (arg == "-keepmodified") {
+				flag_keepmodified = true;
+				continue;
+			}
 			if (arg == "-defer") {
 				flag_defer = true;
 				continue;
@@ -488,7 +515,8 @@ struct VerilogFrontend : public Frontend {
 			error_on_dpi_function(current_ast);
 
 		AST::process(design, current_ast, flag_dump_ast1, flag_dump_ast2, flag_no_dump_ptr, flag_dump_vlog1, flag_dump_vlog2, flag_dump_rtlil, flag_nolatches,
-				flag_nomeminit, flag_nomem2reg, flag_mem2reg, flag_noblackbox, lib_mode, flag_nowb, flag_noopt, flag_icells, flag_pwires, flag_nooverwrite, flag_overwrite, flag_defer, default_nettype_wire);
+				flag_nomeminit, flag_nomem2reg, flag_mem2reg, flag_noblackbox, lib_mode, flag_nowb, flag_noopt, flag_icells, flag_pwires, flag_nooverwrite, flag_overwrite, flag_defer, default_nettype_wire,
+				flag_incremental, flag_keepmodified);
 
 
 		if (!flag_nopp)
@@ -591,7 +591,10 @@ public:
 	template<typename Compare = std::less<K>>
 	void sort(Compare comp = Compare())
 	{
-		std::sort(entries.begin(), entries.end(), [comp](const entry_t &a, const entry_t &b){ return comp(b.udata.first, a.udata.first); });
+		auto cmp = [comp](const entry_t &a, const entry_t &b){ return comp(b.udata.first, a.udata.first); };
+		if (std::is_sorted(entries.begin(), entries.end(), cmp))
+			return;
+		std::sort(entries.begin(), entries.end(), cmp);
 		do_rehash();
 	}
 
@@ -943,7 +946,10 @@ public:
 	template<typename Compare = std::less<K>>
 	void sort(Compare comp = Compare())
 	{
-		std::sort(entries.begin(), entries.end(), [comp](const entry_t &a, const entry_t &b){ return comp(b.udata, a.udata); });
+		auto cmp = [comp](const entry_t &a, const entry_t &b){ return comp(b.udata, a.udata); };
+		if (std::is_sorted(entries.begin(), entries.end(), cmp))
+			return;
+		std::sort(entries.begin(), entries.end(), cmp);
 		do_rehash();
 	}
 
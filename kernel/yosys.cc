@@ -207,6 +207,24 @@ std::string vstringf(const char *fmt, va_list ap)
 	return string;
 }
 
+// same as str += stringf("%d", value), without the temporary string
+void append_decimal(std::string &str, int value)
+{
+	char digits[16];
+	int n = 0;
+
+	unsigned int v = value < 0 ? -(unsigned int)value : value;
+	do {
+		digits[n++] = '0' + v % 10;
+		v /= 10;
+	} while (v);
+
+	if (value < 0)
+		str.push_back('-');
+	while (n)
+		str.push_back(digits[--n]);
+}
+
 int readsome(std::istream &f, char *s, int n)
 {
 	int rc = int(f.readsome(s, n));
@@ -266,7 +266,7 @@ void read_liberty_cellarea(dict<IdString, double> &cell_area, string liberty_fil
 	yosys_input_files.insert(liberty_file);
 	if (f.fail())
 		log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-	LibertyParser libparser(f);
+	LibertyParser libparser(f, {"timing", "internal_power", "leakage_power"});
 	f.close();
 
 	for (auto cell : libparser.ast->children)
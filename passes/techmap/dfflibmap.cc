@@ -596,7 +596,7 @@ struct DfflibmapPass : public Pass {
 		f.open(liberty_file.c_str());
 		if (f.fail())
 			log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-		LibertyParser libparser(f);
+		LibertyParser libparser(f, {"timing", "internal_power", "leakage_power"});
 		f.close();
 
 		find_cell(libparser.ast, ID($_DFF_N_), false, false, false, false, prepare_mode);
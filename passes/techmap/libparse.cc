@@ -89,20 +89,20 @@ int LibertyParser::lexer(std::string &str)
 
 	// eat whitespace
 	do {
-		c = f.get();
+		c = get();
 	} while (c == ' ' || c == '\t' || c == '\r');
 
 	// search for identifiers, numbers, plus or minus.
 	if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.') {
 		str = static_cast<char>(c);
 		while (1) {
-			c = f.get();
+			c = get();
 			if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.')
 				str += c;
 			else
 				break;
 		}
-		f.unget();
+		unget();
 		if (str == "+" || str == "-") {
 			/* Single operator is not an identifier */
 			// fprintf(stderr, "LEX: char >>%s<<\n", str.c_str());
@@ -119,7 +119,7 @@ int LibertyParser::lexer(std::string &str)
 	if (c == '"') {
 		str = "";
 		while (1) {
-			c = f.get();
+			c = get();
 			if (c == '\n')
 				line++;
 			if (c == '"')
@@ -132,37 +132,37 @@ int LibertyParser::lexer(std::string &str)
 
 	// if it wasn't a string, perhaps it's a comment or a forward slash?
 	if (c == '/') {
-		c = f.get();
+		c = get();
 		if (c == '*') {         // start of '/*' block comment
 			int last_c = 0;
 			while (c > 0 && (last_c != '*' || c != '/')) {
 				last_c = c;
-				c = f.get();
+				c = get();
 				if (c == '\n')
 					line++;
 			}
 			return lexer(str);
 		} else if (c == '/') {  // start of '//' line comment
 			while (c > 0 && c != '\n')
-				c = f.get();
+				c = get();
 			line++;
 			return lexer(str);
 		}
-		f.unget();
+		unget();
 		// fprintf(stderr, "LEX: char >>/<<\n");
 		return '/';             // a single '/' charater.
 	}
 
 	// check for a backslash
 	if (c == '\\') {
-		c = f.get();		
+		c = get();		
 		if (c == '\r')
-			c = f.get();
+			c = get();
 		if (c == '\n') {
 			line++;
 			return lexer(str);
 		}
-		f.unget();
+		unget();
 		return '\\';
 	}
 
@@ -337,6 +337,10 @@ LibertyAst *LibertyParser::parse()
 		}
 
 		if (tok == '{') {
+			if (skip_groups.count(ast->id)) {
+				skip_group();
+				break;
+			}
 			while (1) {
 				LibertyAst *child = parse();
 				if (child == NULL)
@@ -352,6 +356,22 @@ LibertyAst *LibertyParser::parse()
 	return ast;
 }
 
+void LibertyParser::skip_group()
+{
+	std::string str;
+	int depth = 1;
+
+	while (depth > 0) {
+		int tok = lexer(str);
+		if (tok < 0)
+			break;
+		if (tok == '{')
+			depth++;
+		if (tok == '}')
+			depth--;
+	}
+}
+
 #ifndef FILTERLIB
 
 void LibertyParser::error()
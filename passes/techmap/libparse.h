@@ -21,6 +21,7 @@
 #define LIBPARSE_H
 
 #include <stdio.h>
+#include <istream>
 #include <string>
 #include <vector>
 #include <set>
@@ -43,8 +44,14 @@ namespace Yosys
 	{
 		std::istream &f;
 		int line;
+		std::set<std::string> skip_groups;
+		int last_char;
 		LibertyAst *ast;
-		LibertyParser(std::istream &f) : f(f), line(1), ast(parse()) {}
+
+		// Groups with an id in skip_groups (e.g. "timing") are lexed but not
+		// stored: they show up in the AST as nodes without children.
+		LibertyParser(std::istream &f, const std::set<std::string> &skip_groups = std::set<std::string>()) :
+				f(f), line(1), skip_groups(skip_groups), last_char(EOF), ast(parse()) {}
 		~LibertyParser() { if (ast) delete ast; }
         
         /* lexer return values:
@@ -53,8 +60,13 @@ namespace Yosys
            anything else is a single character.
         */
 		int lexer(std::string &str);
+		// sbumpc() does not advance the stream when it returns EOF, so only
+		// a character that was actually read is put back.
+		int get() { return last_char = f.rdbuf()->sbumpc(); }
+		void unget() { if (last_char != EOF) f.rdbuf()->sungetc(); }
 		
         LibertyAst *parse();
+        void skip_group();
 		void error();
         void error(const std::string &str);
 	};
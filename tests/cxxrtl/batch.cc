@@ -0,0 +1,87 @@
+// Tests for batches of instances stepped in lockstep, see run-test.sh.
+//
+// The model is force-included (`-include model.cc`). Every lane of a batch is driven through the debug interface of
+// the batch with the stimulus of driver.cc, but with a different seed; the checksum of every lane must match the one
+// of an instance simulated on its own with the same seed.
+//
+// Usage: batch
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <backends/cxxrtl/cxxrtl_batch.h>
+
+#include "tap.h"
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			exit(1); \
+		} \
+	} while (0)
+
+static const long cycles = 500;
+static const size_t lanes = 5;
+
+static uint32_t next_lfsr(uint32_t lfsr)
+{
+	return (lfsr >> 1) ^ (-(lfsr & 1u) & 0x80200003u);
+}
+
+static uint32_t simulate(uint32_t seed)
+{
+	cxxrtl_design::p_top top;
+	cxxrtl::debug_items items;
+	top.debug_info(items);
+	uint32_t lfsr = seed, checksum = 0;
+	for (long i = 0; i < cycles; i++) {
+		lfsr = next_lfsr(lfsr);
+		set_port(items.at("rst"), i < 4);
+		set_port(items.at("in"), lfsr);
+		set_port(items.at("clk"), 0);
+		top.step();
+		set_port(items.at("clk"), 1);
+		top.step();
+		checksum = (checksum * 31) ^ items.at("out").curr[0];
+	}
+	return checksum;
+}
+
+int main()
+{
+	std::unique_ptr<cxxrtl::batch<cxxrtl_design::p_top, lanes>> batch(new cxxrtl::batch<cxxrtl_design::p_top, lanes>);
+	cxxrtl::debug_items items;
+	batch->debug_info(items);
+	CHECK(items.table.count("clk") == 0);
+
+	uint32_t lfsrs[lanes], checksums[lanes] = {};
+	for (size_t lane = 0; lane < lanes; lane++)
+		lfsrs[lane] = lane + 1;
+	auto port = [&](size_t lane, const char *name) -> const cxxrtl::debug_item & {
+		return items.at("lane_" + std::to_string(lane) + " " + name);
+	};
+	for (long i = 0; i < cycles; i++) {
+		for (size_t lane = 0; lane < lanes; lane++) {
+			lfsrs[lane] = next_lfsr(lfsrs[lane]);
+			set_port(port(lane, "rst"), i < 4);
+			set_port(port(lane, "in"), lfsrs[lane]);
+			set_port(port(lane, "clk"), 0);
+		}
+		batch->step();
+		for (size_t lane = 0; lane < lanes; lane++)
+			set_port(port(lane, "clk"), 1);
+		CHECK(batch->step() > 0);
+		for (size_t lane = 0; lane < lanes; lane++)
+			checksums[lane] = (checksums[lane] * 31) ^ port(lane, "out").curr[0];
+	}
+
+	for (size_t lane = 0; lane < lanes; lane++)
+		CHECK(checksums[lane] == simulate(lane + 1));
+	// The lanes are independent: different seeds give different results.
+	CHECK(checksums[0] != checksums[1]);
+	// Lanes can also be accessed directly.
+	CHECK(&batch->lane(lanes - 1) != &batch->lane(0));
+	printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Simulation driver for the CXXRTL tests, see run-test.sh.
+//
+// The model is force-included (`-include model.cc` or `-include model.h`). It drives the ports `clk`, `rst`, `in`
+// and `out` of the top module `top` through the debug interface and prints a checksum of the outputs, so that
+// the models generated with different options can be compared. The black box `tap` is implemented in tap.h.
+//
+// If built with -DACTIVITY for a model generated with `write_cxxrtl -activity`, it also checks that instances
+// were both evaluated and skipped, and that the evaluation counters are not exposed as debug items.
+//
+// Usage: driver <cycles>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "tap.h"
+
+int main(int argc, char **argv)
+{
+	long cycles = argc > 1 ? atol(argv[1]) : 1000;
+
+	cxxrtl_design::p_top top;
+	cxxrtl::debug_items items;
+	top.debug_info(items);
+	const cxxrtl::debug_item &clk = items.at("clk");
+	const cxxrtl::debug_item &rst = items.at("rst");
+	const cxxrtl::debug_item &in = items.at("in");
+	const cxxrtl::debug_item &out = items.at("out");
+
+	uint32_t lfsr = 1, checksum = 0;
+	for (long i = 0; i < cycles; i++) {
+		lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0x80200003u);
+		set_port(rst, i < 4);
+		set_port(in, lfsr);
+		set_port(clk, 0);
+		top.step();
+		set_port(clk, 1);
+		top.step();
+		checksum = (checksum * 31) ^ out.curr[0];
+	}
+	printf("%08x\n", checksum);
+
+#ifdef ACTIVITY
+	for (auto &it : items.table)
+		if (strstr(it.first.c_str(), "$activity")) {
+			fprintf(stderr, "Activity counter `%s' exposed as a debug item.\n", it.first.c_str());
+			return 1;
+		}
+	cxxrtl::activity_stats stats;
+	top.activity_info(stats);
+	uint64_t evaluated = 0, skipped = 0;
+	for (auto &it : stats.table) {
+		evaluated += it.second.evaluated;
+		skipped += it.second.skipped;
+	}
+	fprintf(stderr, "%zu instances, %llu evaluated, %llu skipped.\n", stats.table.size(),
+	        (unsigned long long)evaluated, (unsigned long long)skipped);
+	if (evaluated == 0 || skipped == 0)
+		return 1;
+#endif
+	return 0;
+}
@@ -0,0 +1,86 @@
+// Hierarchical design for the CXXRTL tests, see run-test.sh.
+//
+// The top module `top` has the ports `clk`, `rst`, `in[31:0]` and `out[31:0]`
+// and instantiates several independent units, so that the model can be split
+// between translation units and evaluated in parallel. The black box `tap` is
+// implemented in tap.h.
+
+(* cxxrtl_blackbox *)
+module tap(clk, data, out);
+	(* cxxrtl_edge = "p" *) input clk;
+	input [31:0] data;
+	(* cxxrtl_sync *) output [31:0] out;
+	// the implementation registers data + 32'h 9e3779b9
+endmodule
+
+module accumulator(input clk, rst, input [31:0] in, output reg [31:0] out);
+	always @(posedge clk)
+		if (rst)
+			out <= 0;
+		else
+			out <= out + (in ^ {out[15:0], out[31:16]});
+endmodule
+
+module multiplier(input clk, rst, input [31:0] in, output reg [31:0] out);
+	reg [31:0] a, b;
+	always @(posedge clk)
+		if (rst) begin
+			a <= 1;
+			b <= 1;
+			out <= 0;
+		end else begin
+			a <= in | 1;
+			b <= a;
+			out <= a * b + out;
+		end
+endmodule
+
+module scratchpad(input clk, rst, input [31:0] in, output reg [31:0] out);
+	reg [31:0] mem [0:63];
+	reg [5:0] ptr;
+	wire [31:0] in_tap;
+	tap t(clk, in, in_tap);
+	integer i;
+	initial
+		for (i = 0; i < 64; i = i + 1)
+			mem[i] = i * 32'h 9e3779b9;
+	always @(posedge clk)
+		if (rst) begin
+			ptr <= 0;
+			out <= 0;
+		end else begin
+			mem[in[5:0]] <= in_tap ^ out;
+			out <= mem[ptr] + out;
+			ptr <= ptr + in[7:6] + 1;
+		end
+endmodule
+
+module delay(input clk, input [31:0] in, output [31:0] out);
+	tap t(clk, in, out);
+endmodule
+
+module sequencer(input clk, rst, input [31:0] in, output reg [31:0] out);
+	reg [1:0] state;
+	wire [31:0] in_delayed;
+	delay d(clk, in, in_delayed);
+	always @(posedge clk)
+		if (rst) begin
+			state <= 0;
+			out <= 0;
+		end else
+			case (state)
+				0: begin out <= out + in_delayed; state <= in[0] ? 1 : 2; end
+				1: begin out <= out - in; state <= 3; end
+				2: begin out <= out ^ in; state <= in[1] ? 3 : 0; end
+				3: begin out <= {out[30:0], out[31]}; state <= 0; end
+			endcase
+endmodule
+
+module top(input clk, rst, input [31:0] in, output [31:0] out);
+	wire [31:0] out_acc, out_mul, out_mem, out_seq;
+	accumulator acc(clk, rst, in, out_acc);
+	multiplier mul(clk, rst, {in[15:0], in[31:16]}, out_mul);
+	scratchpad mem(clk, rst, in, out_mem);
+	sequencer seq(clk, rst, in + out_mem, out_seq);
+	assign out = out_acc ^ out_mul ^ out_mem ^ out_seq;
+endmodule
@@ -0,0 +1,55 @@
+#!/bin/bash
+# Tests for the models generated by write_cxxrtl. Every test compiles the
+# model of hier.v with different options and compares the outputs printed by
+# driver.cc with the ones of the model generated with the default options.
+
+set -ex
+
+CXX=${CXX:-c++}
+CXXFLAGS="-std=c++14 -O1 -I../.. -I."
+
+mkdir -p work
+rm -f work/*
+
+../../yosys -q -p "read_verilog hier.v; hierarchy -top top; write_cxxrtl work/reference.cc"
+$CXX $CXXFLAGS -include work/reference.cc -o work/reference driver.cc
+./work/reference > work/reference.out
+
+# -split: every unit is compiled on its own and linked together
+../../yosys -q -p "read_verilog hier.v; hierarchy -top top; write_cxxrtl -noflatten -header -split 3 work/split.cc"
+test -f work/split.h -a -f work/split_1.cc -a -f work/split_2.cc
+for unit in work/split.cc work/split_1.cc work/split_2.cc; do
+	$CXX $CXXFLAGS -c -o ${unit%.cc}.o $unit
+done
+$CXX $CXXFLAGS -include work/split.h -o work/split driver.cc work/split.o work/split_1.o work/split_2.o
+./work/split > work/split.out
+cmp work/reference.out work/split.out
+
+# -parallel: the black box `tap` aborts if it is evaluated on a worker thread
+../../yosys -q -p "read_verilog hier.v; hierarchy -top top; write_cxxrtl -noflatten -parallel work/parallel.cc"
+$CXX $CXXFLAGS -pthread -include work/parallel.cc -o work/parallel driver.cc
+CXXRTL_THREADS=4 ./work/parallel > work/parallel.out
+cmp work/reference.out work/parallel.out
+
+# two threads simulating their own instances dispatch to the same worker pool
+$CXX $CXXFLAGS -pthread -include work/parallel.cc -o work/threads threads.cc
+CXXRTL_THREADS=4 ./work/threads > work/threads.out
+cat work/reference.out work/reference.out | cmp - work/threads.out
+
+# -activity: the counters move, and skipping instances does not change the outputs
+../../yosys -q -p "read_verilog hier.v; hierarchy -top top; write_cxxrtl -noflatten -activity work/activity.cc"
+$CXX $CXXFLAGS -DACTIVITY -include work/activity.cc -o work/activity driver.cc
+./work/activity > work/activity.out
+cmp work/reference.out work/activity.out
+
+# snapshots: saving, restoring, incremental snapshots shared between instances, and errors
+$CXX $CXXFLAGS -DCXXRTL_INCLUDE_CAPI_IMPL -include work/reference.cc -o work/snapshot snapshot.cc
+./work/snapshot
+
+# binary waveforms: converted to VCD, they are identical to the VCD written directly
+$CXX $CXXFLAGS -DCXXRTL_INCLUDE_WAVEFORM_CAPI_IMPL -DCXXRTL_INCLUDE_VCD_CAPI_IMPL -include work/reference.cc -o work/waveform waveform.cc
+./work/waveform work
+
+# batches: every lane matches an instance simulated on its own
+$CXX $CXXFLAGS -include work/reference.cc -o work/batch batch.cc
+./work/batch
@@ -0,0 +1,121 @@
+// Tests for design state snapshots, see run-test.sh.
+//
+// The model is force-included (`-include model.cc`) together with the C API. Every test simulates the design
+// with the same stimulus as driver.cc after saving or restoring a snapshot, and checks that the simulation resumes
+// exactly where the snapshot was saved.
+//
+// Usage: snapshot
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "tap.h"
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			exit(1); \
+		} \
+	} while (0)
+
+struct simulation {
+	cxxrtl_design::p_top top;
+	cxxrtl::debug_items items;
+	uint32_t lfsr;
+
+	simulation(uint32_t seed) : lfsr(seed) {
+		top.debug_info(items);
+	}
+
+	uint32_t run(long cycles) {
+		const cxxrtl::debug_item &clk = items.at("clk");
+		const cxxrtl::debug_item &rst = items.at("rst");
+		const cxxrtl::debug_item &in = items.at("in");
+		const cxxrtl::debug_item &out = items.at("out");
+		uint32_t checksum = 0;
+		for (long i = 0; i < cycles; i++) {
+			lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0x80200003u);
+			set_port(rst, 0);
+			set_port(in, lfsr);
+			set_port(clk, 0);
+			top.step();
+			set_port(clk, 1);
+			top.step();
+			checksum = (checksum * 31) ^ out.curr[0];
+		}
+		return checksum;
+	}
+};
+
+static void test_restore(bool incremental)
+{
+	simulation sim(1);
+	sim.run(100);
+	cxxrtl::snapshot state;
+	for (int i = 0; i < 10; i++) {
+		state.save(sim.top, incremental);
+		uint32_t lfsr = sim.lfsr;
+		uint32_t expected = sim.run(50);
+		CHECK(state.restore(sim.top, incremental));
+		sim.lfsr = lfsr;
+		CHECK(sim.run(50) == expected);
+
+		cxxrtl::snapshot full;
+		full.save(sim.top);
+		state.save(sim.top, incremental);
+		CHECK(state.buffer() == full.buffer());
+		CHECK(state.restore(sim.top, incremental));
+	}
+}
+
+// A snapshot is saved from one instance and restored into another, then both are simulated; an incremental restore
+// into the second instance must also copy the memory rows written only by the first one.
+static void test_cross_instance()
+{
+	simulation source(1), target(2);
+	source.run(100);
+	cxxrtl::snapshot state;
+	state.save(source.top, /*incremental=*/true);
+	CHECK(state.restore(target.top, /*incremental=*/true));
+	source.run(50);
+	target.run(50);
+	state.save(source.top, /*incremental=*/true);
+	CHECK(state.restore(target.top, /*incremental=*/true));
+
+	cxxrtl::snapshot source_state, target_state;
+	source_state.save(source.top);
+	target_state.save(target.top);
+	CHECK(source_state.buffer() == target_state.buffer());
+	target.lfsr = source.lfsr;
+	CHECK(source.run(50) == target.run(50));
+}
+
+static void test_errors()
+{
+	simulation sim(1);
+	cxxrtl::snapshot state;
+	CHECK(!state.restore(sim.top));
+	CHECK(!state.restore(sim.top, /*incremental=*/true));
+
+	cxxrtl_handle handle = cxxrtl_create(cxxrtl_design_create());
+	cxxrtl_snapshot snapshot = cxxrtl_snapshot_create();
+	CHECK(cxxrtl_snapshot_restore(snapshot, handle, 0) == 0);
+	cxxrtl_snapshot_save(snapshot, handle, 0);
+	CHECK(cxxrtl_snapshot_restore(snapshot, handle, 0) == 1);
+	size_t chunks;
+	cxxrtl_snapshot_data(snapshot, &chunks);
+	CHECK(chunks > 0);
+	cxxrtl_snapshot_destroy(snapshot);
+	cxxrtl_destroy(handle);
+}
+
+int main()
+{
+	test_restore(/*incremental=*/false);
+	test_restore(/*incremental=*/true);
+	test_cross_instance();
+	test_errors();
+	printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,37 @@
+// Implementation of the black box `tap` for the CXXRTL tests, see run-test.sh.
+//
+// It checks that it is always evaluated on the thread that created the model, which is the thread running the
+// simulation. Must be included after the model.
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace cxxrtl_design {
+
+struct tap_impl : public bb_p_tap {
+	const std::thread::id owner_thread_id = std::this_thread::get_id();
+
+	bool eval() override {
+		if (std::this_thread::get_id() != owner_thread_id) {
+			fprintf(stderr, "Black box evaluated on a worker thread.\n");
+			abort();
+		}
+		if (posedge_p_clk())
+			p_out.next = p_data.add(value<32>{0x9e3779b9u});
+		return bb_p_tap::eval();
+	}
+};
+
+std::unique_ptr<bb_p_tap> bb_p_tap::create(std::string name, cxxrtl::metadata_map parameters,
+                                           cxxrtl::metadata_map attributes) {
+	return std::unique_ptr<bb_p_tap>(new tap_impl);
+}
+
+}
+
+static void set_port(const cxxrtl::debug_item &item, uint32_t data)
+{
+	uint32_t *target = item.next ? item.next : item.curr;
+	target[0] = item.width < 32 ? data & ((1u << item.width) - 1) : data;
+}
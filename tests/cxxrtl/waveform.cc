@@ -0,0 +1,147 @@
+// Tests for the binary waveform writer, see run-test.sh.
+//
+// The model is force-included (`-include model.cc`) together with the C APIs. The design is simulated with the same
+// stimulus as driver.cc while it is sampled by both a VCD writer and a waveform writer; the waveform converted
+// to VCD must be identical to the VCD written directly. Small blocks are used, so that the waveform consists
+// of many blocks.
+//
+// Usage: waveform <directory>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <backends/cxxrtl/cxxrtl_vcd_capi.h>
+#include <backends/cxxrtl/cxxrtl_waveform_capi.h>
+
+#include "tap.h"
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+			exit(1); \
+		} \
+	} while (0)
+
+static const long cycles = 200;
+
+template<class Sample>
+static void simulate(cxxrtl::module &top, const cxxrtl::debug_items &items, Sample sample)
+{
+	const cxxrtl::debug_item &clk = items.at("clk");
+	const cxxrtl::debug_item &rst = items.at("rst");
+	const cxxrtl::debug_item &in = items.at("in");
+	uint32_t lfsr = 1;
+	uint64_t timestamp = 0;
+	top.step();
+	sample(timestamp);
+	for (long i = 0; i < cycles; i++) {
+		lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0x80200003u);
+		set_port(rst, i < 4);
+		set_port(in, lfsr);
+		set_port(clk, 0);
+		top.step();
+		// Several samples at the same timestamp, and samples without changes, must round-trip too.
+		sample(timestamp);
+		timestamp += 5;
+		sample(timestamp);
+		set_port(clk, 1);
+		top.step();
+		timestamp += 5;
+		sample(timestamp);
+	}
+}
+
+static void test_writer(bool with_memories)
+{
+	cxxrtl_design::p_top top;
+	cxxrtl::debug_items items;
+	top.debug_info(items);
+
+	cxxrtl::vcd_writer vcd;
+	cxxrtl::waveform_writer waveform;
+	waveform.block_size = 256;
+	vcd.timescale(1, "ns");
+	waveform.timescale(1, "ns");
+	if (with_memories) {
+		vcd.add(items);
+		waveform.add(items);
+	} else {
+		vcd.add_without_memories(items);
+		waveform.add_without_memories(items);
+	}
+	simulate(top, items, [&](uint64_t timestamp) {
+		vcd.sample(timestamp);
+		waveform.sample(timestamp);
+	});
+	waveform.flush();
+
+	std::istringstream in(waveform.buffer);
+	std::ostringstream out;
+	CHECK(cxxrtl::waveform_to_vcd(in, out));
+	CHECK(out.str() == vcd.buffer);
+
+	// A truncated waveform is rejected.
+	std::istringstream truncated(waveform.buffer.substr(0, waveform.buffer.size() - 1));
+	std::ostringstream discarded;
+	CHECK(!cxxrtl::waveform_to_vcd(truncated, discarded));
+}
+
+static void test_capi(const std::string &directory)
+{
+	cxxrtl_handle handle = cxxrtl_create(cxxrtl_design_create());
+	const cxxrtl::debug_items &items = cxxrtl_debug_items_from_handle(handle);
+
+	cxxrtl_vcd vcd = cxxrtl_vcd_create();
+	cxxrtl_waveform waveform = cxxrtl_waveform_create();
+	cxxrtl_waveform_block_size(waveform, 1000);
+	cxxrtl_vcd_add_from(vcd, handle);
+	cxxrtl_waveform_add_from(waveform, handle);
+
+	std::string vcd_data, waveform_data;
+	auto read = [&] {
+		const char *data;
+		size_t size;
+		cxxrtl_vcd_read(vcd, &data, &size);
+		vcd_data.append(data, size);
+		cxxrtl_waveform_read(waveform, &data, &size);
+		waveform_data.append(data, size);
+	};
+	const cxxrtl::debug_item &clk = items.at("clk");
+	const cxxrtl::debug_item &in = items.at("in");
+	for (uint64_t timestamp = 0; timestamp < cycles; timestamp++) {
+		set_port(clk, timestamp & 1);
+		set_port(in, timestamp * 0x9e3779b9u);
+		cxxrtl_step(handle);
+		cxxrtl_vcd_sample(vcd, timestamp);
+		cxxrtl_waveform_sample(waveform, timestamp);
+		read();
+	}
+	cxxrtl_waveform_flush(waveform);
+	read();
+	cxxrtl_waveform_destroy(waveform);
+	cxxrtl_vcd_destroy(vcd);
+	cxxrtl_destroy(handle);
+
+	std::string waveform_path = directory + "/waveform.bin";
+	std::string vcd_path = directory + "/waveform.vcd";
+	std::ofstream(waveform_path, std::ios::binary) << waveform_data;
+	CHECK(cxxrtl_waveform_to_vcd(waveform_path.c_str(), vcd_path.c_str()) == 1);
+	std::ifstream converted(vcd_path, std::ios::binary);
+	std::ostringstream converted_data;
+	converted_data << converted.rdbuf();
+	CHECK(converted_data.str() == vcd_data);
+	CHECK(cxxrtl_waveform_to_vcd((directory + "/nonexistent.bin").c_str(), vcd_path.c_str()) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	std::string directory = argc > 1 ? argv[1] : ".";
+	test_writer(/*with_memories=*/true);
+	test_writer(/*with_memories=*/false);
+	test_capi(directory);
+	printf("ok\n");
+	return 0;
+}
@@ -0,0 +1,130 @@
+// Simulation driver for the CXXRTL benchmarks, see run-bench.sh.
+//
+// The model generated by `write_cxxrtl` for one of the designs is force-included (`-include model.cc`). Every design
+// has a top module `bench` with the ports `clk`, `rst`, `in[31:0]` and `out[31:0]`; the ports are accessed through
+// the debug interface, so that the driver does not depend on how the backend represents them.
+//
+// Usage: bench <cycles> [<vcd-file>]
+//        bench <cycles> -w <waveform-file>
+//
+// With a file name, all signals except for memories are sampled after every step and written to a VCD file, or,
+// with -w, to a binary waveform file (see cxxrtl_waveform.h). Prints a JSON object with the results to stdout.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <sys/resource.h>
+
+#include <backends/cxxrtl/cxxrtl_vcd.h>
+#include <backends/cxxrtl/cxxrtl_waveform.h>
+
+static void set_port(const cxxrtl::debug_item &item, uint32_t data)
+{
+	// Wires are written through `next` and become visible on commit; for values `next` aliases `curr`.
+	uint32_t *target = item.next ? item.next : item.curr;
+	size_t chunks = (item.width + 31) / 32;
+	target[0] = item.width < 32 ? data & ((1u << item.width) - 1) : data;
+	for (size_t n = 1; n < chunks; n++)
+		target[n] = 0;
+}
+
+int main(int argc, char **argv)
+{
+	bool waveform_format = argc == 4 && std::string(argv[2]) == "-w";
+	if (argc < 2 || argc > 4 || (argc == 4 && !waveform_format)) {
+		fprintf(stderr, "Usage: %s <cycles> [<vcd-file>]\n", argv[0]);
+		fprintf(stderr, "       %s <cycles> -w <waveform-file>\n", argv[0]);
+		return 1;
+	}
+
+	long cycles = atol(argv[1]);
+	const char *trace_filename = argc > 2 ? argv[argc - 1] : nullptr;
+
+	static cxxrtl_design::p_bench top;
+
+	cxxrtl::debug_items items;
+	top.debug_info(items);
+	const cxxrtl::debug_item &clk = items.at("clk");
+	const cxxrtl::debug_item &rst = items.at("rst");
+	const cxxrtl::debug_item &in = items.at("in");
+	const cxxrtl::debug_item &out = items.at("out");
+
+	std::ofstream trace_file;
+	cxxrtl::vcd_writer vcd;
+	cxxrtl::waveform_writer waveform;
+	if (trace_filename) {
+		trace_file.open(trace_filename, std::ios::binary);
+		if (!trace_file) {
+			fprintf(stderr, "Cannot open `%s' for writing.\n", trace_filename);
+			return 1;
+		}
+		if (waveform_format) {
+			waveform.timescale(1, "us");
+			waveform.add_without_memories(items);
+		} else {
+			vcd.timescale(1, "us");
+			vcd.add_without_memories(items);
+		}
+	}
+
+	uint32_t lfsr = 1, checksum = 0;
+	size_t deltas = 0;
+	uint64_t timestamp = 0;
+
+	auto sample = [&]() {
+		if (!trace_filename)
+			return;
+		std::string &buffer = waveform_format ? waveform.buffer : vcd.buffer;
+		if (waveform_format)
+			waveform.sample(timestamp++);
+		else
+			vcd.sample(timestamp++);
+		if (buffer.size() > (1 << 20)) {
+			trace_file << buffer;
+			buffer.clear();
+		}
+	};
+
+	auto clock = [&]() {
+		set_port(clk, 0);
+		deltas += top.step();
+		sample();
+		set_port(clk, 1);
+		deltas += top.step();
+		sample();
+	};
+
+	set_port(rst, 1);
+	set_port(in, 0);
+	for (int i = 0; i < 4; i++)
+		clock();
+	set_port(rst, 0);
+	deltas = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (long i = 0; i < cycles; i++) {
+		// Galois LFSR with the maximal-length polynomial x^32 + x^22 + x^2 + x + 1.
+		lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0x80200003u);
+		set_port(in, lfsr);
+		clock();
+		checksum = (checksum * 31) ^ out.curr[0];
+	}
+	if (trace_filename) {
+		waveform.flush();
+		trace_file << (waveform_format ? waveform.buffer : vcd.buffer);
+		trace_file.flush();
+	}
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	printf("{\"cycles\": %ld, \"seconds\": %.6f, \"cycles_per_second\": %.1f, \"deltas_per_cycle\": %.3f, "
+	       "\"model_bytes\": %zu, \"max_rss_kb\": %ld, \"checksum\": \"%08x\"}\n",
+	       cycles, seconds, seconds > 0 ? cycles / seconds : 0.0, cycles > 0 ? (double)deltas / cycles : 0.0,
+	       sizeof(top), (long)usage.ru_maxrss, checksum);
+	return 0;
+}
@@ -0,0 +1,71 @@
+// Control-heavy design: many small state machines (fsm_test from
+// tests/simple/fsm.v and subbytes_00 from tests/simple/subbytes.v) and a
+// 32-way round-robin arbiter.
+
+module bench(clk, rst, in, out);
+
+input clk, rst;
+input [31:0] in;
+output [31:0] out;
+
+wire [63:0] lights;
+wire [127:0] sub_data;
+wire [3:0] sub_ready;
+
+genvar i;
+generate
+	for (i = 0; i < 16; i = i + 1) begin:fsms
+		fsm_test fsm (
+			.clk(clk), .reset(rst),
+			.button_a(in[2*i]), .button_b(in[2*i+1]),
+			.red_a(lights[4*i]), .green_a(lights[4*i+1]),
+			.red_b(lights[4*i+2]), .green_b(lights[4*i+3])
+		);
+	end
+	for (i = 0; i < 4; i = i + 1) begin:subs
+		wire [7:0] sbox_in, sbox_out;
+		wire sbox_decrypt;
+		subbytes_00 sub (
+			.clk(clk), .reset(!rst),
+			.start_i(in[i]), .decrypt_i(in[4+i]),
+			.data_i(in ^ lights[31:0]),
+			.ready_o(sub_ready[i]), .data_o(sub_data[32*i +: 32]),
+			.sbox_data_o(sbox_out), .sbox_data_i(sbox_in),
+			.sbox_decrypt_o(sbox_decrypt)
+		);
+		assign sbox_in = sbox_decrypt ? {sbox_out[2:0], sbox_out[7:3]} ^ 8'h05 :
+				{sbox_out[4:0], sbox_out[7:5]} ^ 8'h63;
+	end
+endgenerate
+
+reg [31:0] pending;
+reg [4:0] grant, next_grant, idx;
+reg found;
+integer k;
+
+always @* begin
+	next_grant = grant;
+	found = 0;
+	for (k = 1; k <= 32; k = k + 1) begin
+		idx = grant + k;
+		if (!found && pending[idx]) begin
+			next_grant = idx;
+			found = 1;
+		end
+	end
+end
+
+always @(posedge clk) begin
+	if (rst) begin
+		pending <= 0;
+		grant <= 0;
+	end else begin
+		pending <= (pending | in | lights[63:32]) & ~(found ? 32'd1 << next_grant : 32'd0);
+		grant <= next_grant;
+	end
+end
+
+assign out = lights[31:0] ^ lights[63:32] ^ sub_data[31:0] ^ sub_data[63:32] ^
+		sub_data[95:64] ^ sub_data[127:96] ^ {23'h0, sub_ready, grant};
+
+endmodule
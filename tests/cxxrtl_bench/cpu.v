@@ -0,0 +1,81 @@
+// Single-cycle 32-bit RISC core executing a pseudo-random program.
+//
+// Every instruction is `op rd, ra, rb, imm16`. Branches are only taken when
+// in[31] is set, so that the program does not get stuck in short loops.
+
+module bench(clk, rst, in, out);
+
+input clk, rst;
+input [31:0] in;
+output reg [31:0] out;
+
+reg [31:0] imem [0:255];
+reg [31:0] dmem [0:1023];
+reg [31:0] regs [0:15];
+reg [7:0] pc;
+
+integer i;
+initial begin
+	for (i = 0; i < 256; i = i + 1)
+		imem[i] = (i * 32'h9e3779b9) ^ ((i * 32'h85ebca6b) >> 11);
+	for (i = 0; i < 16; i = i + 1)
+		regs[i] = 0;
+end
+
+wire [31:0] insn = imem[pc];
+wire [3:0] op = insn[31:28];
+wire [3:0] rd = insn[27:24];
+wire [3:0] ra = insn[23:20];
+wire [3:0] rb = insn[19:16];
+wire [15:0] imm = insn[15:0];
+
+wire [31:0] a = regs[ra];
+wire [31:0] b = regs[rb];
+wire [31:0] simm = {{16{imm[15]}}, imm};
+
+wire [9:0] addr = a[9:0] + imm[9:0];
+wire [31:0] load_data = dmem[addr];
+
+wire taken = in[31] && ((op == 13 && a == b) || (op == 14 && a != b));
+
+reg [31:0] result;
+reg wen;
+
+always @* begin
+	wen = 1;
+	case (op)
+		0: result = a + b;
+		1: result = a - b;
+		2: result = a & b;
+		3: result = a | b;
+		4: result = a ^ b;
+		5: result = a << b[4:0];
+		6: result = a >> b[4:0];
+		7: result = $signed(a) < $signed(b);
+		8: result = a * b;
+		9: result = a + simm;
+		10: result = {imm, 16'h0000};
+		11: result = load_data;
+		15: result = in ^ a;
+		default: begin
+			result = 0;
+			wen = 0;
+		end
+	endcase
+end
+
+always @(posedge clk) begin
+	if (rst) begin
+		pc <= 0;
+		out <= 0;
+	end else begin
+		pc <= taken ? pc + {imm[6:0], 1'b1} : pc + 1;
+		if (wen && rd != 0)
+			regs[rd] <= result;
+		if (op == 12)
+			dmem[addr] <= b;
+		out <= out ^ result;
+	end
+end
+
+endmodule
@@ -0,0 +1,35 @@
+// Wide datapath: a pipeline of 256-bit arithmetic, shift and compare stages
+// with a 128x128 bit multiplier and 64-bit dividers.
+
+module bench(clk, rst, in, out);
+
+input clk, rst;
+input [31:0] in;
+output [31:0] out;
+
+reg [255:0] s0, s1, s2, s3, acc;
+reg [63:0] quot, rem;
+
+always @(posedge clk) begin
+	if (rst) begin
+		s0 <= 0;
+		s1 <= 0;
+		s2 <= 0;
+		s3 <= 0;
+		acc <= 0;
+		quot <= 0;
+		rem <= 0;
+	end else begin
+		s0 <= {s0[223:0], in} ^ {in, s3[255:32]};
+		s1 <= s0 + {s0[127:0], s0[255:128]};
+		s2 <= s1 ^ (s1 >> 7) ^ (s1 << in[7:0]);
+		s3 <= s2[127:0] * s2[255:128];
+		acc <= (s3 > acc) ? s3 - acc : acc + (s2 & ~s1);
+		quot <= s1[63:0] / (s2[63:0] | 64'd1);
+		rem <= s2[127:64] % (s1[127:64] | 64'd1);
+	end
+end
+
+assign out = acc[31:0] ^ acc[255:224] ^ quot[31:0] ^ rem[63:32];
+
+endmodule
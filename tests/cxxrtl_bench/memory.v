@@ -0,0 +1,43 @@
+// Memory-heavy design: large memories with several read and write ports,
+// including a read-modify-write histogram.
+
+module bench(clk, rst, in, out);
+
+input clk, rst;
+input [31:0] in;
+output reg [31:0] out;
+
+reg [31:0] mem_a [0:4095];
+reg [63:0] mem_b [0:1023];
+reg [15:0] hist [0:255];
+
+reg [31:0] lfsr;
+reg [31:0] rd_a;
+reg [63:0] rd_b;
+reg [15:0] rd_h;
+
+wire [11:0] addr_a0 = lfsr[11:0] ^ in[11:0];
+wire [11:0] addr_a1 = lfsr[23:12];
+wire [9:0] addr_b = lfsr[31:22] ^ in[21:12];
+wire [7:0] bucket = in[31:24] ^ lfsr[7:0];
+
+always @(posedge clk) begin
+	if (rst) begin
+		lfsr <= 32'h00000001;
+		out <= 0;
+	end else begin
+		lfsr <= {lfsr[30:0], lfsr[31] ^ lfsr[21] ^ lfsr[1] ^ lfsr[0]};
+		if (in[0])
+			mem_a[addr_a0] <= in ^ rd_a;
+		if (in[1])
+			mem_a[addr_a1] <= lfsr + rd_a;
+		mem_b[addr_b] <= {rd_a, in} + rd_b;
+		hist[bucket] <= hist[bucket] + 1;
+		rd_a <= mem_a[addr_a1 ^ 12'h5a5];
+		rd_b <= mem_b[addr_b + 10'd1];
+		rd_h <= hist[~bucket];
+		out <= rd_a ^ rd_b[31:0] ^ rd_b[63:32] ^ {16'h0000, rd_h};
+	end
+end
+
+endmodule
@@ -0,0 +1,108 @@
+// Microbenchmarks for the arithmetic and logic operations of the CXXRTL runtime, see run-bench.sh.
+//
+// Every operation is timed on a pool of pseudo-random operands for a range of widths, repeating it until the
+// measurement takes long enough to be meaningful. Prints a JSON array with one object per operation and width.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <backends/cxxrtl/cxxrtl.h>
+
+using namespace cxxrtl;
+using namespace cxxrtl_yosys;
+
+static const size_t pool_size = 1024;
+static const double min_seconds = 0.05;
+
+static uint32_t xorshift_state = 0x12345678;
+
+static uint32_t xorshift()
+{
+	xorshift_state ^= xorshift_state << 13;
+	xorshift_state ^= xorshift_state >> 17;
+	xorshift_state ^= xorshift_state << 5;
+	return xorshift_state;
+}
+
+template<size_t Bits>
+static value<Bits> random_value()
+{
+	value<Bits> result;
+	for (size_t n = 0; n < result.chunks; n++)
+		result.data[n] = xorshift();
+	result.data[result.chunks - 1] &= value<Bits>::msb_mask;
+	return result;
+}
+
+// Keeps the results alive, so that the measured operations are not optimized out.
+static volatile uint32_t sink;
+
+static bool first_result = true;
+
+template<size_t Bits, class Operation>
+static void measure(const char *name, Operation operation)
+{
+	std::vector<value<Bits>> a, b;
+	std::vector<value<8>> s;
+	for (size_t i = 0; i < pool_size; i++) {
+		a.push_back(random_value<Bits>());
+		b.push_back(random_value<Bits>());
+		// Division by zero takes a shortcut, keep the divisors non-zero.
+		b.back().data[0] |= 1;
+		s.push_back(random_value<8>());
+	}
+
+	size_t iterations = pool_size;
+	double seconds = 0;
+	while (true) {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++) {
+			size_t index = i % pool_size;
+			sink = sink ^ operation(a[index], b[index], s[index]).data[0];
+		}
+		auto stop = std::chrono::steady_clock::now();
+		seconds = std::chrono::duration<double>(stop - start).count();
+		if (seconds >= min_seconds)
+			break;
+		iterations *= 2;
+	}
+
+	printf("%s\n  {\"op\": \"%s\", \"width\": %zu, \"ns_per_op\": %.3f}", first_result ? "" : ",",
+	       name, Bits, seconds * 1e9 / iterations);
+	first_result = false;
+}
+
+template<size_t Bits>
+static void measure_width()
+{
+	typedef const value<Bits> &operand;
+	typedef const value<8> &amount;
+	measure<Bits>("and", [](operand a, operand b, amount) { return and_uu<Bits>(a, b); });
+	measure<Bits>("xor", [](operand a, operand b, amount) { return xor_uu<Bits>(a, b); });
+	measure<Bits>("add", [](operand a, operand b, amount) { return add_uu<Bits>(a, b); });
+	measure<Bits>("sub", [](operand a, operand b, amount) { return sub_uu<Bits>(a, b); });
+	measure<Bits>("mul", [](operand a, operand b, amount) { return mul_uu<Bits>(a, b); });
+	measure<Bits>("mul_wide", [](operand a, operand b, amount) { return mul_uu<2 * Bits>(a, b); });
+	measure<Bits>("div", [](operand a, operand b, amount) { return div_uu<Bits>(a, b); });
+	measure<Bits>("mod", [](operand a, operand b, amount) { return mod_uu<Bits>(a, b); });
+	measure<Bits>("div_signed", [](operand a, operand b, amount) { return div_ss<Bits>(a, b); });
+	measure<Bits>("shl", [](operand a, operand, amount s) { return shl_uu<Bits>(a, s); });
+	measure<Bits>("shr", [](operand a, operand, amount s) { return shr_uu<Bits>(a, s); });
+	measure<Bits>("sshr", [](operand a, operand, amount s) { return sshr_uu<Bits>(a, s); });
+	measure<Bits>("eq", [](operand a, operand b, amount) { return eq_uu<1>(a, b); });
+	measure<Bits>("lt", [](operand a, operand b, amount) { return lt_uu<1>(a, b); });
+}
+
+int main()
+{
+	printf("[");
+	measure_width<8>();
+	measure_width<32>();
+	measure_width<64>();
+	measure_width<128>();
+	measure_width<256>();
+	measure_width<1024>();
+	printf("\n]\n");
+	return 0;
+}
@@ -0,0 +1,109 @@
+#!/bin/bash
+#
+# Benchmarks the models generated by write_cxxrtl, see README.
+#
+# Usage: run-bench.sh [-o <output.json>] [-n <cycles>] [<design>...]
+#
+# Environment: YOSYS (default ../../yosys), CXX (default c++), CXXFLAGS (default -O3),
+# WRITE_CXXRTL_ARGS (extra options for write_cxxrtl).
+
+set -e
+
+YOSYS=${YOSYS:-$PWD/../../yosys}
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O3}
+output=bench.json
+cycles=100000
+
+while getopts "o:n:" opt; do
+	case "$opt" in
+		o) output="$OPTARG" ;;
+		n) cycles="$OPTARG" ;;
+		*) echo "Usage: $0 [-o <output.json>] [-n <cycles>] [<design>...]" >&2; exit 1 ;;
+	esac
+done
+shift $((OPTIND-1))
+
+# Sources of each design; the top module is always `bench`.
+declare -A sources
+sources[cpu]="cpu.v"
+sources[datapath]="datapath.v"
+sources[memory]="memory.v"
+sources[control]="../simple/fsm.v ../simple/subbytes.v control.v"
+
+designs="$@"
+if [ -z "$designs" ]; then
+	designs="cpu datapath memory control"
+fi
+
+# Prints the time since $1 (from `date +%s%N`) in seconds.
+elapsed() {
+	local ns=$(( $(date +%s%N) - $1 ))
+	printf "%d.%03d" $(( ns / 1000000000 )) $(( ns / 1000000 % 1000 ))
+}
+
+mkdir -p work
+commit=$(git rev-parse HEAD 2>/dev/null || echo unknown)
+cxx_version=$($CXX --version | head -n 1)
+
+{
+	echo "{"
+	echo "  \"commit\": \"$commit\","
+	echo "  \"cxx\": \"${cxx_version//\"/\\\"}\","
+	echo "  \"cxxflags\": \"$CXXFLAGS\","
+	echo "  \"cycles\": $cycles,"
+	echo "  \"designs\": ["
+} > work/results.json
+
+separator=""
+for design in $designs; do
+	if [ -z "${sources[$design]}" ]; then
+		echo "Unknown design \`$design'." >&2
+		exit 1
+	fi
+	echo "Benchmarking $design."
+
+	start=$(date +%s%N)
+	$YOSYS -q -l work/$design.log -p "read_verilog ${sources[$design]}; hierarchy -top bench; write_cxxrtl $WRITE_CXXRTL_ARGS work/$design.cc"
+	gen_seconds=$(elapsed $start)
+
+	start=$(date +%s%N)
+	$CXX -std=c++14 $CXXFLAGS -I../.. -include work/$design.cc -o work/$design bench.cc
+	compile_seconds=$(elapsed $start)
+	binary_bytes=$(wc -c < work/$design)
+
+	run=$(./work/$design $cycles)
+	run_vcd=$(./work/$design $cycles work/$design.vcd)
+	vcd_bytes=$(wc -c < work/$design.vcd)
+	run_waveform=$(./work/$design $cycles -w work/$design.bin)
+	waveform_bytes=$(wc -c < work/$design.bin)
+	rm -f work/$design.vcd work/$design.bin
+
+	{
+		echo "$separator    {"
+		echo "      \"name\": \"$design\","
+		echo "      \"gen_seconds\": $gen_seconds,"
+		echo "      \"compile_seconds\": $compile_seconds,"
+		echo "      \"binary_bytes\": $binary_bytes,"
+		echo "      \"run\": $run,"
+		echo "      \"run_vcd\": $run_vcd,"
+		echo "      \"vcd_bytes\": $vcd_bytes,"
+		echo "      \"run_waveform\": $run_waveform,"
+		echo "      \"waveform_bytes\": $waveform_bytes"
+		echo -n "    }"
+	} >> work/results.json
+	separator=$',\n'
+done
+
+echo "Running microbenchmarks."
+$CXX -std=c++14 $CXXFLAGS -I../.. -o work/micro micro.cc
+{
+	echo
+	echo "  ],"
+	echo -n "  \"micro\": "
+	./work/micro | sed '2,$s/^/  /'
+	echo "}"
+} >> work/results.json
+
+mv work/results.json "$output"
+echo "Results written to $output."
@@ -31,7 +31,7 @@ end
 
 import json
 import argparse
-import sys, socket, os, subprocess
+import sys, socket, os, subprocess, tempfile
 try:
 	import msvcrt, win32pipe, win32file
 except ImportError:
@@ -51,6 +51,10 @@ def map_parameter(parameter):
 	if parameter["type"] == "real":
 		return float(parameter["value"])
 
+# In the "stdio path" mode, derived modules are written to temporary files and returned by path.
+use_path = False
+paths = []
+
 def call(input_json):
 	input = json.loads(input_json)
 	if input["method"] == "modules":
@@ -59,27 +63,40 @@ def call(input_json):
 		try:
 			frontend, source = derive(input["module"],
 				{name: map_parameter(value) for name, value in input["parameters"].items()})
+			if use_path:
+				fd, path = tempfile.mkstemp(suffix=".rpc")
+				with os.fdopen(fd, "w") as f:
+					f.write(source)
+				paths.append(path)
+				return json.dumps({"frontend": frontend, "path": path})
 			return json.dumps({"frontend": frontend, "source": source})
 		except ValueError as e:
 			return json.dumps({"error": str(e)})
 
 def main():
+	global use_path
 	parser = argparse.ArgumentParser()
 	modes = parser.add_subparsers(dest="mode")
 	mode_stdio = modes.add_parser("stdio")
+	mode_stdio.add_argument("response", nargs="?", choices=["source", "path"], default="source")
 	if os.name == "posix":
 		mode_path = modes.add_parser("unix-socket")
 	if os.name == "nt":
 		mode_path = modes.add_parser("named-pipe")
 	mode_path.add_argument("path")
 	args = parser.parse_args()
+	use_path = args.mode == "stdio" and args.response == "path"
 
 	if args.mode == "stdio":
-		while True:
-			input = sys.stdin.readline()
-			if not input: break
-			sys.stdout.write(call(input) + "\n")
-			sys.stdout.flush()
+		try:
+			while True:
+				input = sys.stdin.readline()
+				if not input: break
+				sys.stdout.write(call(input) + "\n")
+				sys.stdout.flush()
+		finally:
+			for path in paths:
+				os.unlink(path)
 
 	if args.mode == "unix-socket":
 		sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
@@ -0,0 +1,45 @@
+#!/bin/bash
+# Test write_btor -coi, and that the BTOR and SMT2 output of a design with
+# shared slices and concatenations checks the same properties as the design.
+
+trap 'echo "ERROR in btor_coi.sh" >&2; exit 1' ERR
+
+for mode in pass fail; do
+	defines=""
+	if [ $mode = fail ]; then
+		defines="-DFAIL"
+	fi
+	../../yosys -q -p "read_verilog -formal $defines btor_coi.v; prep -top top; flatten; memory_map; opt -fast
+		write_btor btor_coi_$mode.btor; write_btor -coi btor_coi_${mode}_coi.btor
+		write_smt2 -wires btor_coi_$mode.smt2"
+
+	# outputs and the logic only driving them are dropped with -coi
+	grep -q " output " btor_coi_$mode.btor
+	grep -q " mul " btor_coi_$mode.btor
+	test "$(grep -c " output " btor_coi_${mode}_coi.btor)" = 0
+	test "$(grep -c " mul " btor_coi_${mode}_coi.btor)" = 0
+	grep -q " bad " btor_coi_${mode}_coi.btor
+
+	if command -v yosys-smtbmc > /dev/null && command -v yices-smt2 > /dev/null; then
+		if [ $mode = pass ]; then
+			yosys-smtbmc -s yices -i -t 12 btor_coi_$mode.smt2 > btor_coi_$mode.out
+		else
+			if yosys-smtbmc -s yices -t 12 btor_coi_$mode.smt2 > btor_coi_$mode.out; then
+				false
+			fi
+		fi
+	fi
+
+	if command -v btormc > /dev/null; then
+		for f in btor_coi_$mode.btor btor_coi_${mode}_coi.btor; do
+			btormc -kmax 12 $f > ${f%.btor}.out
+			if [ $mode = pass ]; then
+				test "$(grep -c "^sat" ${f%.btor}.out)" = 0
+			else
+				grep -q "^sat" ${f%.btor}.out
+			fi
+		done
+	fi
+done
+
+rm -f btor_coi_*.btor btor_coi_*.smt2
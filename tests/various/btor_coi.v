@@ -0,0 +1,18 @@
+module top(input clk, input [7:0] a, b, output [7:0] x, y);
+	reg [7:0] ring = 1, shift = 0, other = 0;
+
+	always @(posedge clk) begin
+		ring <= {ring[6:0], ring[7]};
+		shift <= {shift[6:0], a[0]};
+		other <= other ^ a;
+	end
+
+	assign x = ring ^ shift;
+	assign y = a * b + other;
+
+`ifdef FAIL
+	always @* assert (shift != 8'h 5a);
+`else
+	always @* assert (ring != 0 && {ring[3:0], ring[7:4]} != 0);
+`endif
+endmodule
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+trap 'echo "ERROR in read_json_modules.sh" >&2; exit 1' ERR
+
+# Modules are imported in file order
+../../yosys -f json - > read_json_modules.log <<EOT
+{ "modules": { "b": {}, "a": {}, "c": {} } }
+EOT
+grep "^Importing module" read_json_modules.log | tr '\n' ' ' | grep -q "^Importing module b .*Importing module a .*Importing module c "
+
+# A module defined twice in the same file is an error
+if ../../yosys -f json - > read_json_modules.log 2>&1 <<EOT
+{ "modules": { "a": {}, "a": { "attributes": { "x": "1" } } } }
+EOT
+then
+	false
+fi
+grep -q "Re-definition of module a" read_json_modules.log
+rm -f read_json_modules.log